@@ -0,0 +1,36 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "SolverBenchmark.h"
+
+// Number of allocations the program made so far
+// Only the RubiksCubeAllocations target defines this, it replaces the global operator new to count them
+int64_t GetAllocationCount();
+
+// Plays many turns through the move queue and the animation and returns the number of allocations they made
+// playTurn queues one turn and animates it to the end, the first turns are played before counting so buffers that grow once are left out
+template<typename PlayTurn>
+static int64_t RunAllocationBenchmark(int turnCount, PlayTurn playTurn)
+{
+	for (int i = 0; i < 1000; ++i)
+	{
+		playTurn();
+	}
+
+	int64_t allocationsBefore = GetAllocationCount();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < turnCount; ++i)
+	{
+		playTurn();
+	}
+
+	double time = GetElapsedMilliseconds(start);
+	int64_t allocations = GetAllocationCount() - allocationsBefore;
+
+	std::cout << "Played " << turnCount << " turns in " << time << " ms, " << allocations << " allocations" << std::endl;
+
+	return allocations;
+}
@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CubeState.h"
+#include "FaceletString.h"
+#include "Notation.h"
+#include "PruningTable.h"
+#include "PuzzleState.h"
+#include "TwoPhaseSolver.h"
+
+// Solves a stream of scrambles or cube states, one per line, on every core and writes one solution per line in the order the lines came in
+// Only a fixed window of lines is held at once, so memory stays the same no matter how long the stream is
+// Lines that are neither valid scrambles nor valid cube states are answered with "error", cubes no solution was found for with "unsolved"
+// Empty lines are passed through
+
+struct BatchSolverSettings
+{
+	int threadCount = GetDefaultThreadCount();
+	int targetLength = 20;
+
+	// Nodes one line may search, with or without a solution, so no line can hold back the lines written after it
+	int64_t nodeLimit = defaultTwoPhaseNodeLimit;
+
+	// Lines that can be read ahead of the oldest line that has not been written yet
+	int windowSize = 4096;
+};
+
+struct BatchSolverJob
+{
+	std::string line;
+	std::string solution;
+	double milliseconds = 0.0;
+	bool done = false;
+};
+
+// Solve times in steps of 10 microseconds up to 10 seconds, the last bucket holds everything slower
+// Keeps the percentiles exact enough while using the same memory for a hundred scrambles or a hundred million
+struct LatencyHistogram
+{
+	static const int bucketCount = 1000001;
+	static constexpr double bucketMilliseconds = 0.01;
+
+	std::vector<int64_t> buckets;
+	int64_t count = 0;
+	double slowest = 0.0;
+
+	LatencyHistogram() : buckets(bucketCount, 0)
+	{
+	}
+
+	void Add(double milliseconds)
+	{
+		++buckets[std::min(bucketCount - 1, (int)(milliseconds / bucketMilliseconds))];
+		++count;
+		slowest = std::max(slowest, milliseconds);
+	}
+
+	// Upper edge of the bucket that holds the given fraction of all solves
+	double GetPercentile(double fraction) const
+	{
+		int64_t rank = std::max<int64_t>(1, (int64_t)(fraction * count + 0.5));
+		int64_t seen = 0;
+
+		for (int i = 0; i < bucketCount - 1; ++i)
+		{
+			seen += buckets[i];
+
+			if (seen >= rank)
+			{
+				return std::min(slowest, (i + 1) * bucketMilliseconds);
+			}
+		}
+
+		return slowest;
+	}
+};
+
+struct BatchSolverReport
+{
+	int64_t solveCount = 0;
+	int64_t errorCount = 0;
+	int64_t failedCount = 0;
+	int64_t longCount = 0;
+	int64_t totalLength = 0;
+	double seconds = 0.0;
+	LatencyHistogram latency;
+};
+
+// Per thread buffers, reused for every line so solving a line only allocates inside the search
+struct BatchSolverBuffers
+{
+	static const int moveCapacity = 1024;
+	static const int textCapacity = 4096;
+
+	MoveCode scramble[moveCapacity];
+	MoveCode solution[moveCapacity];
+	char text[textCapacity];
+	PuzzleState puzzleState = PuzzleState(3);
+};
+
+// Solves one line into job.solution, returns the number of moves or -1 if the line is neither a scramble nor a valid cube state
+// Scrambles may contain slices and rotations, the solution is written for the cube as it is held at the end of the scramble
+// A line of 54 facelets is solved as it is, without replaying any moves
+static int SolveBatchLine(TwoPhaseSolver& solver, const BatchSolverSettings& settings, BatchSolverBuffers& buffers, BatchSolverJob& job, bool& solved)
+{
+	CubeState state;
+	buffers.puzzleState.Reset();
+
+	int faceletError = ParseFaceletString(job.line.data(), (int)job.line.size(), state);
+
+	if (faceletError == FACELETLENGTH)
+	{
+		int scrambleLength = ParseMoveCodes(job.line.data(), (int)job.line.size(), buffers.scramble, BatchSolverBuffers::moveCapacity);
+
+		if (scrambleLength < 0)
+		{
+			job.solution = "error";
+			return -1;
+		}
+
+		for (int i = 0; i < scrambleLength; ++i)
+		{
+			ApplyMoveCode(state, buffers.puzzleState, buffers.scramble[i]);
+		}
+	}
+	else if (faceletError != FACELETSVALID)
+	{
+		job.solution = "error";
+		return -1;
+	}
+
+	std::vector<int> solution = solver.Solve(state, settings.targetLength, settings.nodeLimit, &solved);
+
+	for (size_t i = 0; i < solution.size(); ++i)
+	{
+		buffers.solution[i] = GetCentreMoveCode(buffers.puzzleState, solution[i]);
+	}
+
+	// A line that ran out of nodes before any solution was found is answered with "unsolved"
+	if (!solved)
+	{
+		job.solution = "unsolved";
+		return 0;
+	}
+
+	FormatMoveCodes(buffers.solution, (int)solution.size(), buffers.text, BatchSolverBuffers::textCapacity);
+	job.solution.assign(buffers.text);
+
+	return (int)solution.size();
+}
+
+static BatchSolverReport RunBatchSolver(std::istream& input, std::ostream& output, const BatchSolverSettings& settings)
+{
+	BatchSolverReport report;
+
+	// Build or map the tables once before the clock starts, every thread shares them
+	GetTwoPhaseTables();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::vector<BatchSolverJob> jobs(settings.windowSize);
+	std::mutex mutex;
+	std::condition_variable jobRead;
+	std::condition_variable jobSolved;
+	std::condition_variable jobWritten;
+
+	// Lines are read, solved and written in this order, the three counters never pass each other
+	int64_t readCount = 0;
+	int64_t takenCount = 0;
+	int64_t writtenCount = 0;
+	bool inputEnded = false;
+
+	std::vector<std::thread> threads;
+
+	for (int thread = 0; thread < settings.threadCount; ++thread)
+	{
+		threads.push_back(std::thread([&]()
+		{
+			// Per thread search state, only the tables are shared
+			TwoPhaseSolver solver;
+			std::unique_ptr<BatchSolverBuffers> buffers(new BatchSolverBuffers());
+
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				jobRead.wait(lock, [&]() { return takenCount < readCount || inputEnded; });
+
+				if (takenCount == readCount)
+				{
+					break;
+				}
+
+				BatchSolverJob& job = jobs[takenCount++ % settings.windowSize];
+				lock.unlock();
+
+				bool solved = true;
+				int length = 0;
+
+				if (!job.line.empty())
+				{
+					std::chrono::steady_clock::time_point solveStart = std::chrono::steady_clock::now();
+					length = SolveBatchLine(solver, settings, *buffers, job, solved);
+					job.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - solveStart).count();
+				}
+
+				lock.lock();
+
+				if (length < 0)
+				{
+					++report.errorCount;
+				}
+				else if (!job.line.empty())
+				{
+					++report.solveCount;
+					report.failedCount += solved ? 0 : 1;
+					report.longCount += length > settings.targetLength ? 1 : 0;
+					report.totalLength += length;
+					report.latency.Add(job.milliseconds);
+				}
+
+				job.done = true;
+				jobSolved.notify_all();
+			}
+		}));
+	}
+
+	// Writes every finished line at the front of the window
+	std::thread writer([&]()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (true)
+		{
+			jobSolved.wait(lock, [&]() { return (writtenCount < readCount && jobs[writtenCount % settings.windowSize].done) || (inputEnded && writtenCount == readCount); });
+
+			if (writtenCount == readCount)
+			{
+				break;
+			}
+
+			BatchSolverJob& job = jobs[writtenCount % settings.windowSize];
+			lock.unlock();
+
+			output << job.solution << '\n';
+
+			lock.lock();
+			job.done = false;
+			++writtenCount;
+			jobWritten.notify_one();
+		}
+
+		output.flush();
+	});
+
+	std::string line;
+
+	while (std::getline(input, line))
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		jobWritten.wait(lock, [&]() { return readCount - writtenCount < settings.windowSize; });
+
+		BatchSolverJob& job = jobs[readCount % settings.windowSize];
+		job.line.swap(line);
+		job.solution.clear();
+		++readCount;
+
+		jobRead.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		inputEnded = true;
+		jobRead.notify_all();
+		jobSolved.notify_all();
+	}
+
+	for (int thread = 0; thread < settings.threadCount; ++thread)
+	{
+		threads[thread].join();
+	}
+
+	writer.join();
+
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return report;
+}
+
+static void PrintBatchSolverReport(const BatchSolverReport& report, std::ostream& stream)
+{
+	stream << "Solved " << report.solveCount << " cubes in " << report.seconds << " s, " << (report.seconds > 0.0 ? report.solveCount / report.seconds : 0.0) << " solves/s" << std::endl;
+	stream << report.errorCount << " lines were neither scrambles nor valid cubes, " << report.failedCount << " cubes were not solved, " << report.longCount << " solutions were longer than the target" << std::endl;
+
+	if (report.solveCount > 0)
+	{
+		const LatencyHistogram& latency = report.latency;
+
+		stream << "Average length " << (double)report.totalLength / report.solveCount << " moves" << std::endl;
+		stream << "Latency median " << latency.GetPercentile(0.5) << " ms, 90th percentile " << latency.GetPercentile(0.9) << " ms, 99th percentile " << latency.GetPercentile(0.99);
+		stream << " ms, 99.9th percentile " << latency.GetPercentile(0.999) << " ms, slowest " << latency.slowest << " ms" << std::endl;
+	}
+}
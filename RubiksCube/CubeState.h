@@ -0,0 +1,356 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "RotationGroup.h"
+
+// Faces, corners and edges of the logical cube, named after the standard U R F D L B notation
+// U is the white side, R orange, F blue, D yellow, L red and B green, matching the cube built in BuildRubiksCube
+enum CubeFaces { UFACE, RFACE, FFACE, DFACE, LFACE, BFACE };
+enum Corners { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum Edges { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+// Converts the colour of a centre cubie (Faces) to the logical face it sits on
+static const int faceToCubeFace[6] = { UFACE, RFACE, FFACE, LFACE, BFACE, DFACE };
+
+// A face turn as a permutation of the slots it moves
+// Slot i receives the piece that was in source[i], twisted or flipped by the given amount
+struct CubeMove
+{
+	uint8_t cornerSource[8];
+	uint8_t cornerTwist[8];
+	uint8_t edgeSource[12];
+	uint8_t edgeFlip[12];
+};
+
+// The geometry every move is generated from, positions of the slots in the frame of the centres with x towards R, y towards U and z towards F
+// Stickers of a slot are counted from the U or D sticker, or the F or B sticker for the four middle edges, and go around corners clockwise
+// A twist or flip is the sticker of the slot that shows the U or D, or F or B, sticker of the piece
+static constexpr int8_t cornerPositions[8][3] =
+{
+	{ 1, 1, 1 }, { -1, 1, 1 }, { -1, 1, -1 }, { 1, 1, -1 }, { 1, -1, 1 }, { -1, -1, 1 }, { -1, -1, -1 }, { 1, -1, -1 }
+};
+
+static constexpr int8_t edgePositions[12][3] =
+{
+	{ 1, 1, 0 }, { 0, 1, 1 }, { -1, 1, 0 }, { 0, 1, -1 }, { 1, -1, 0 }, { 0, -1, 1 },
+	{ -1, -1, 0 }, { 0, -1, -1 }, { 1, 0, 1 }, { -1, 0, 1 }, { -1, 0, -1 }, { 1, 0, -1 }
+};
+
+// Going clockwise around a corner visits y, x, z on corners with an even number of negative coordinates and y, z, x on the others
+static constexpr int8_t cornerStickerAxes[2][3] = { { 1, 2, 0 }, { 1, 0, 2 } };
+
+// Returns the axis the given sticker of a slot faces
+static constexpr int GetCornerStickerAxis(int corner, int sticker)
+{
+	const int8_t* position = cornerPositions[corner];
+
+	return cornerStickerAxes[position[0] * position[1] * position[2] > 0 ? 1 : 0][sticker];
+}
+
+static constexpr int GetEdgeStickerAxis(int edge, int sticker)
+{
+	const int8_t* position = edgePositions[edge];
+
+	if (position[1] != 0)
+	{
+		return sticker == 0 ? 1 : (position[0] != 0 ? 0 : 2);
+	}
+
+	return sticker == 0 ? 2 : 0;
+}
+
+// Returns the slot at the position the rotation moves the given slot to
+static constexpr int GetRotatedSlot(const int8_t (*positions)[3], int slotCount, const CubeRotation& rotation, int slot)
+{
+	int rotated[3] = {};
+
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 3; ++column)
+		{
+			rotated[row] += rotation.matrix[row][column] * positions[slot][column];
+		}
+	}
+
+	for (int target = 0; target < slotCount; ++target)
+	{
+		if (positions[target][0] == rotated[0] && positions[target][1] == rotated[1] && positions[target][2] == rotated[2])
+		{
+			return target;
+		}
+	}
+
+	return slot;
+}
+
+// Returns the axis a direction along the given axis points along once the rotation is applied
+static constexpr int GetRotatedAxis(const CubeRotation& rotation, int axis)
+{
+	return rotation.matrix[0][axis] != 0 ? 0 : (rotation.matrix[1][axis] != 0 ? 1 : 2);
+}
+
+// Generates the clockwise quarter turn of a face by rotating every slot on it
+// Seen from the U, R or F end of an axis a clockwise turn is three counter clockwise quarter turns, seen from the other end it is one
+static constexpr CubeMove BuildBasicCubeMove(int face)
+{
+	CubeMove move = {};
+
+	const int8_t* normal = rotationFaceNormals[face];
+	int axis = normal[0] != 0 ? 0 : (normal[1] != 0 ? 1 : 2);
+	int side = normal[axis];
+
+	CubeRotation turn = GetQuarterTurn(axis);
+
+	if (face < 3)
+	{
+		turn = MultiplyRotations(turn, MultiplyRotations(turn, turn));
+	}
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		move.cornerSource[corner] = corner;
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		move.edgeSource[edge] = edge;
+	}
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		if (cornerPositions[corner][axis] == side)
+		{
+			int target = GetRotatedSlot(cornerPositions, 8, turn, corner);
+			int stickerAxis = GetRotatedAxis(turn, GetCornerStickerAxis(corner, 0));
+
+			move.cornerSource[target] = corner;
+			move.cornerTwist[target] = GetCornerStickerAxis(target, 0) == stickerAxis ? 0 : (GetCornerStickerAxis(target, 1) == stickerAxis ? 1 : 2);
+		}
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		if (edgePositions[edge][axis] == side)
+		{
+			int target = GetRotatedSlot(edgePositions, 12, turn, edge);
+			int stickerAxis = GetRotatedAxis(turn, GetEdgeStickerAxis(edge, 0));
+
+			move.edgeSource[target] = edge;
+			move.edgeFlip[target] = GetEdgeStickerAxis(target, 0) == stickerAxis ? 0 : 1;
+		}
+	}
+
+	return move;
+}
+
+// Chains two moves, the result behaves like applying first and then second
+static constexpr CubeMove CombineCubeMoves(const CubeMove& first, const CubeMove& second)
+{
+	CubeMove result = {};
+
+	for (int i = 0; i < 8; ++i)
+	{
+		result.cornerSource[i] = first.cornerSource[second.cornerSource[i]];
+		result.cornerTwist[i] = (first.cornerTwist[second.cornerSource[i]] + second.cornerTwist[i]) % 3;
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		result.edgeSource[i] = first.edgeSource[second.edgeSource[i]];
+		result.edgeFlip[i] = first.edgeFlip[second.edgeSource[i]] ^ second.edgeFlip[i];
+	}
+
+	return result;
+}
+
+// The 18 face turns, ordered U U2 U' R R2 R' F F2 F' D D2 D' L L2 L' B B2 B'
+struct CubeMoveTable
+{
+	CubeMove moves[18];
+
+	constexpr const CubeMove& operator[](int move) const
+	{
+		return moves[move];
+	}
+};
+
+static constexpr CubeMoveTable BuildCubeMoveTable()
+{
+	CubeMoveTable table = {};
+
+	for (int face = 0; face < 6; ++face)
+	{
+		CubeMove quarterTurn = BuildBasicCubeMove(face);
+
+		table.moves[face * 3] = quarterTurn;
+		table.moves[face * 3 + 1] = CombineCubeMoves(quarterTurn, quarterTurn);
+		table.moves[face * 3 + 2] = CombineCubeMoves(table.moves[face * 3 + 1], quarterTurn);
+	}
+
+	return table;
+}
+
+static constexpr CubeMoveTable cubeMoveTable = BuildCubeMoveTable();
+
+// Checks for the compile time checks below
+static constexpr bool IsIdentityCubeMove(const CubeMove& move)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		if (move.cornerSource[i] != i || move.cornerTwist[i] != 0)
+		{
+			return false;
+		}
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		if (move.edgeSource[i] != i || move.edgeFlip[i] != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static constexpr bool AreCubeMovesEqual(const CubeMove& first, const CubeMove& second)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		if (first.cornerSource[i] != second.cornerSource[i] || first.cornerTwist[i] != second.cornerTwist[i])
+		{
+			return false;
+		}
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		if (first.edgeSource[i] != second.edgeSource[i] || first.edgeFlip[i] != second.edgeFlip[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Every quarter turn has order 4, moves four corners and four edges, keeps the total twist a multiple of 3 and flips an even number of edges
+// Only F and B flip edges, and half turns and counter clockwise turns undo themselves and the quarter turn
+static constexpr bool IsCubeMoveTableValid(const CubeMoveTable& table)
+{
+	for (int face = 0; face < 6; ++face)
+	{
+		const CubeMove& quarterTurn = table[face * 3];
+		const CubeMove& halfTurn = table[face * 3 + 1];
+		const CubeMove& inverseTurn = table[face * 3 + 2];
+
+		if (IsIdentityCubeMove(quarterTurn) || IsIdentityCubeMove(halfTurn) || !IsIdentityCubeMove(CombineCubeMoves(halfTurn, halfTurn)) || !IsIdentityCubeMove(CombineCubeMoves(quarterTurn, inverseTurn)))
+		{
+			return false;
+		}
+
+		int movedCorners = 0;
+		int movedEdges = 0;
+		int twist = 0;
+		int flips = 0;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			movedCorners += quarterTurn.cornerSource[i] != i ? 1 : 0;
+			twist += quarterTurn.cornerTwist[i];
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			movedEdges += quarterTurn.edgeSource[i] != i ? 1 : 0;
+			flips += quarterTurn.edgeFlip[i];
+		}
+
+		if (movedCorners != 4 || movedEdges != 4 || twist % 3 != 0 || flips != (face % 3 == FFACE ? 4 : 0))
+		{
+			return false;
+		}
+
+		// Opposite faces turn different slots, so they commute
+		if (!AreCubeMovesEqual(CombineCubeMoves(quarterTurn, table[(face + 3) % 6 * 3]), CombineCubeMoves(table[(face + 3) % 6 * 3], quarterTurn)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static_assert(IsIdentityCubeMove(CombineCubeMoves(CombineCubeMoves(cubeMoveTable[UFACE * 3], cubeMoveTable[UFACE * 3]), CombineCubeMoves(cubeMoveTable[UFACE * 3], cubeMoveTable[UFACE * 3]))), "U4 has to be the identity");
+static_assert(IsCubeMoveTableValid(cubeMoveTable), "The generated face turns do not behave like face turns");
+
+// Render independent state of the cube, 20 bytes in total
+// Every slot stores the piece sitting in it together with its orientation
+// Corners are stored as piece * 3 + twist and edges as piece * 2 + flip
+// Centres never move relative to each other, so the faces define the frame of reference
+struct CubeState
+{
+	std::array<uint8_t, 8> corners;
+	std::array<uint8_t, 12> edges;
+
+	CubeState()
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			corners[i] = i * 3;
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			edges[i] = i * 2;
+		}
+	}
+
+	// Applies one of the 18 face turns from cubeMoveTable
+	void ApplyMove(int move)
+	{
+		const CubeMove& cubeMove = cubeMoveTable[move];
+
+		std::array<uint8_t, 8> oldCorners = corners;
+		std::array<uint8_t, 12> oldEdges = edges;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			uint8_t corner = oldCorners[cubeMove.cornerSource[i]];
+			uint8_t twist = corner % 3 + cubeMove.cornerTwist[i];
+
+			corners[i] = corner - corner % 3 + (twist >= 3 ? twist - 3 : twist);
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			edges[i] = oldEdges[cubeMove.edgeSource[i]] ^ cubeMove.edgeFlip[i];
+		}
+	}
+
+	// Applies a whole sequence of face turns
+	void ApplyMoves(const int* moves, int moveCount)
+	{
+		for (int i = 0; i < moveCount; ++i)
+		{
+			ApplyMove(moves[i]);
+		}
+	}
+
+	bool IsSolved() const
+	{
+		return *this == CubeState();
+	}
+
+	bool operator==(const CubeState& other) const
+	{
+		return corners == other.corners && edges == other.edges;
+	}
+
+	bool operator!=(const CubeState& other) const
+	{
+		return !(*this == other);
+	}
+};
@@ -0,0 +1,287 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CUBE_BATCH_SSE2
+#endif
+
+#include "CubeState.h"
+
+// Many cube states stored side by side, so one move is applied to a whole block of states at once
+// States are kept in blocks of 64, each block holds one row of 64 bytes for the piece and one for the orientation in every slot
+// All lanes of a row move to the same slot, so a move only changes which row belongs to which slot, no piece is ever copied
+// Only the twists and flips the move adds are computed, 64 lanes at a time
+// Used for analytics like checking which of thousands of scrambles an algorithm solves, the solvers keep using CubeState
+
+static const int cubeBatchLanes = 64;
+
+// Rows of a block, corner pieces, corner twists, edge pieces and edge flips
+static const int cornerPieceRow = 0;
+static const int cornerTwistRow = 8;
+static const int edgePieceRow = 16;
+static const int edgeFlipRow = 28;
+static const int cubeBatchRows = 40;
+
+struct CubeStateBlock
+{
+	uint8_t rows[cubeBatchRows][cubeBatchLanes];
+};
+
+// Twists are below 3, so after adding the twist of the move a lane either is below 3 or wraps once
+// Unsigned minimum of x and x - 3 picks the right one, x - 3 wraps to a large value when x is below 3
+static void TwistBatchRow(const uint8_t* source, uint8_t twist, uint8_t* target)
+{
+#if defined(__AVX2__)
+	__m256i twists = _mm256_set1_epi8(twist);
+	__m256i three = _mm256_set1_epi8(3);
+
+	for (int lane = 0; lane < cubeBatchLanes; lane += 32)
+	{
+		__m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*)(source + lane)), twists);
+		_mm256_storeu_si256((__m256i*)(target + lane), _mm256_min_epu8(sum, _mm256_sub_epi8(sum, three)));
+	}
+#elif defined(CUBE_BATCH_SSE2)
+	__m128i twists = _mm_set1_epi8(twist);
+	__m128i three = _mm_set1_epi8(3);
+
+	for (int lane = 0; lane < cubeBatchLanes; lane += 16)
+	{
+		__m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(source + lane)), twists);
+		_mm_storeu_si128((__m128i*)(target + lane), _mm_min_epu8(sum, _mm_sub_epi8(sum, three)));
+	}
+#else
+	for (int lane = 0; lane < cubeBatchLanes; ++lane)
+	{
+		uint8_t sum = source[lane] + twist;
+		target[lane] = sum >= 3 ? sum - 3 : sum;
+	}
+#endif
+}
+
+static void FlipBatchRow(const uint8_t* source, uint8_t* target)
+{
+#if defined(__AVX2__)
+	__m256i one = _mm256_set1_epi8(1);
+
+	for (int lane = 0; lane < cubeBatchLanes; lane += 32)
+	{
+		_mm256_storeu_si256((__m256i*)(target + lane), _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(source + lane)), one));
+	}
+#elif defined(CUBE_BATCH_SSE2)
+	__m128i one = _mm_set1_epi8(1);
+
+	for (int lane = 0; lane < cubeBatchLanes; lane += 16)
+	{
+		_mm_storeu_si128((__m128i*)(target + lane), _mm_xor_si128(_mm_loadu_si128((const __m128i*)(source + lane)), one));
+	}
+#else
+	for (int lane = 0; lane < cubeBatchLanes; ++lane)
+	{
+		target[lane] = source[lane] ^ 1;
+	}
+#endif
+}
+
+// Slot i of a block is stored in row rows[i] of the corners or edges while moves are applied
+struct CubeBatchRowMap
+{
+	uint8_t cornerRows[8];
+	uint8_t edgeRows[12];
+
+	CubeBatchRowMap()
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			cornerRows[i] = i;
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			edgeRows[i] = i;
+		}
+	}
+};
+
+// Applies a move to every lane of the block, the rows follow their pieces and the twists and flips are changed where they are
+static void ApplyCubeMoveToBlock(const CubeMove& move, CubeBatchRowMap& rowMap, CubeStateBlock& block)
+{
+	CubeBatchRowMap oldRowMap = rowMap;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		rowMap.cornerRows[i] = oldRowMap.cornerRows[move.cornerSource[i]];
+
+		if (move.cornerTwist[i] != 0)
+		{
+			uint8_t* twists = block.rows[cornerTwistRow + rowMap.cornerRows[i]];
+			TwistBatchRow(twists, move.cornerTwist[i], twists);
+		}
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		rowMap.edgeRows[i] = oldRowMap.edgeRows[move.edgeSource[i]];
+
+		if (move.edgeFlip[i] != 0)
+		{
+			uint8_t* flips = block.rows[edgeFlipRow + rowMap.edgeRows[i]];
+			FlipBatchRow(flips, flips);
+		}
+	}
+}
+
+// Puts the rows back in slot order once all moves are applied
+static void ArrangeBlockRows(const CubeBatchRowMap& rowMap, CubeStateBlock& block)
+{
+	CubeStateBlock oldBlock = block;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		memcpy(block.rows[cornerPieceRow + i], oldBlock.rows[cornerPieceRow + rowMap.cornerRows[i]], cubeBatchLanes);
+		memcpy(block.rows[cornerTwistRow + i], oldBlock.rows[cornerTwistRow + rowMap.cornerRows[i]], cubeBatchLanes);
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		memcpy(block.rows[edgePieceRow + i], oldBlock.rows[edgePieceRow + rowMap.edgeRows[i]], cubeBatchLanes);
+		memcpy(block.rows[edgeFlipRow + i], oldBlock.rows[edgeFlipRow + rowMap.edgeRows[i]], cubeBatchLanes);
+	}
+}
+
+// Returns the single move that behaves like the whole sequence of face turns
+static CubeMove GetSequenceCubeMove(const int* moves, int moveCount)
+{
+	CubeMove sequence = {};
+
+	for (int i = 0; i < 8; ++i)
+	{
+		sequence.cornerSource[i] = i;
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		sequence.edgeSource[i] = i;
+	}
+
+	for (int i = 0; i < moveCount; ++i)
+	{
+		sequence = CombineCubeMoves(sequence, cubeMoveTable[moves[i]]);
+	}
+
+	return sequence;
+}
+
+struct CubeStateBatch
+{
+	// Number of states, the last block is filled up with solved states
+	int size = 0;
+	std::vector<CubeStateBlock> blocks;
+
+	// Starts with every state solved
+	explicit CubeStateBatch(int stateCount)
+	{
+		size = stateCount;
+		blocks.resize((stateCount + cubeBatchLanes - 1) / cubeBatchLanes);
+
+		for (CubeStateBlock& block : blocks)
+		{
+			memset(block.rows, 0, sizeof(block.rows));
+
+			for (int i = 0; i < 8; ++i)
+			{
+				memset(block.rows[cornerPieceRow + i], i, cubeBatchLanes);
+			}
+
+			for (int i = 0; i < 12; ++i)
+			{
+				memset(block.rows[edgePieceRow + i], i, cubeBatchLanes);
+			}
+		}
+	}
+
+	void SetState(int index, const CubeState& state)
+	{
+		CubeStateBlock& block = blocks[index / cubeBatchLanes];
+		int lane = index % cubeBatchLanes;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			block.rows[cornerPieceRow + i][lane] = state.corners[i] / 3;
+			block.rows[cornerTwistRow + i][lane] = state.corners[i] % 3;
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			block.rows[edgePieceRow + i][lane] = state.edges[i] / 2;
+			block.rows[edgeFlipRow + i][lane] = state.edges[i] % 2;
+		}
+	}
+
+	CubeState GetState(int index) const
+	{
+		const CubeStateBlock& block = blocks[index / cubeBatchLanes];
+		int lane = index % cubeBatchLanes;
+		CubeState state;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			state.corners[i] = block.rows[cornerPieceRow + i][lane] * 3 + block.rows[cornerTwistRow + i][lane];
+		}
+
+		for (int i = 0; i < 12; ++i)
+		{
+			state.edges[i] = block.rows[edgePieceRow + i][lane] * 2 + block.rows[edgeFlipRow + i][lane];
+		}
+
+		return state;
+	}
+
+	bool IsSolved(int index) const
+	{
+		return GetState(index).IsSolved();
+	}
+
+	// Applies one move to every state
+	void ApplyCubeMove(const CubeMove& move)
+	{
+		for (CubeStateBlock& block : blocks)
+		{
+			CubeBatchRowMap rowMap;
+			ApplyCubeMoveToBlock(move, rowMap, block);
+			ArrangeBlockRows(rowMap, block);
+		}
+	}
+
+	void ApplyMove(int move)
+	{
+		ApplyCubeMove(cubeMoveTable[move]);
+	}
+
+	// Applies a sequence of face turns to every state
+	// Each block goes through the whole sequence while it is in the cache and is only put back in slot order at the end
+	void ApplyMoves(const int* moves, int moveCount)
+	{
+		for (CubeStateBlock& block : blocks)
+		{
+			CubeBatchRowMap rowMap;
+
+			for (int i = 0; i < moveCount; ++i)
+			{
+				ApplyCubeMoveToBlock(cubeMoveTable[moves[i]], rowMap, block);
+			}
+
+			ArrangeBlockRows(rowMap, block);
+		}
+	}
+
+	// Same result as ApplyMoves, the sequence is combined into one move first, so every state is only touched once
+	void ApplyAlgorithm(const int* moves, int moveCount)
+	{
+		ApplyCubeMove(GetSequenceCubeMove(moves, moveCount));
+	}
+};
@@ -0,0 +1,272 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "CubeState.h"
+#include "CubeStateBatch.h"
+
+// Dense indices of cube states, so states can be deduplicated and cached in plain arrays and bitsets instead of hash maps
+// The cube has 43252003274489856000 states, which takes 66 bits, so a state is ranked as a corner rank and an edge rank
+// Corners: Lehmer code of the permutation * 3^7 + the first seven twists, below 8! * 3^7
+// Edges: Lehmer code of the permutation without its last digit * 2^11 + the first eleven flips, below 12! / 2 * 2^11
+// The last digit of the edge permutation only holds its parity, which always matches the parity of the corners
+// Every step is a mask, a table lookup or a multiply and add, with no branches on the state, and the batch version compares whole rows of states
+
+static const uint32_t cornerRankCount = 40320 * 2187;
+static const uint64_t edgeRankCount = 239500800ull * 2048;
+
+struct CubeStateRank
+{
+	uint32_t corners = 0;
+	uint64_t edges = 0;
+
+	bool operator==(const CubeStateRank& other) const
+	{
+		return corners == other.corners && edges == other.edges;
+	}
+
+	bool operator!=(const CubeStateRank& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+// Number of set bits of every 12 bit mask
+static std::array<uint8_t, 4096> BuildBitCounts()
+{
+	std::array<uint8_t, 4096> bitCounts;
+	bitCounts[0] = 0;
+
+	for (int mask = 1; mask < 4096; ++mask)
+	{
+		bitCounts[mask] = bitCounts[mask >> 1] + (mask & 1);
+	}
+
+	return bitCounts;
+}
+
+static const std::array<uint8_t, 4096> bitCounts = BuildBitCounts();
+
+// Lehmer code of the first DigitCount digits, every digit counts the later pieces that are smaller
+// Stored pieces are piece * Divisor + orientation, the pieces are walked from the back with a mask of the ones already seen
+// The sizes are template arguments so the loop is unrolled and every divide and multiply is by a constant
+template<int Count, int DigitCount, int Divisor, typename Code>
+static Code GetLehmerCode(const uint8_t* pieces)
+{
+	Code code = 0;
+	Code weight = 1;
+	int seenPieces = 0;
+
+	for (int i = Count - 1; i >= 0; --i)
+	{
+		int piece = pieces[i] / Divisor;
+
+		if (i < DigitCount)
+		{
+			code += bitCounts[seenPieces & ((1 << piece) - 1)] * weight;
+			weight *= Count - i;
+		}
+
+		seenPieces |= 1 << piece;
+	}
+
+	return code;
+}
+
+static CubeStateRank RankCubeState(const CubeState& state)
+{
+	CubeStateRank rank;
+
+	uint32_t twist = 0;
+	uint64_t flip = 0;
+
+	for (int i = URF; i < DRB; ++i)
+	{
+		twist = twist * 3 + state.corners[i] % 3;
+	}
+
+	for (int i = UR; i < BR; ++i)
+	{
+		flip = flip * 2 + state.edges[i] % 2;
+	}
+
+	rank.corners = GetLehmerCode<8, 8, 3, uint32_t>(state.corners.data()) * 2187 + twist;
+	rank.edges = GetLehmerCode<12, 10, 2, uint64_t>(state.edges.data()) * 2048 + flip;
+
+	return rank;
+}
+
+// Turns Lehmer digits back into pieces, each digit picks a piece from the ones not used yet, counted from the smallest
+// The unused pieces are kept as 4 bit numbers in one integer, so picking and removing one is a few shifts and masks
+template<int Count>
+static void SetLehmerPieces(const int* digits, uint8_t* pieces, int multiplier)
+{
+	uint64_t unused = 0;
+
+	for (int i = Count - 1; i >= 0; --i)
+	{
+		unused = unused << 4 | i;
+	}
+
+	for (int i = 0; i < Count; ++i)
+	{
+		int shift = digits[i] * 4;
+		uint64_t lowerMask = ((uint64_t)1 << shift) - 1;
+
+		pieces[i] = (unused >> shift & 15) * multiplier;
+		unused = (unused & lowerMask) | (unused >> 4 & ~lowerMask);
+	}
+}
+
+// Returns the state with the given rank, the ranks have to be below cornerRankCount and edgeRankCount
+static CubeState UnrankCubeState(const CubeStateRank& rank)
+{
+	CubeState state;
+
+	int cornerDigits[8];
+	int edgeDigits[12];
+
+	uint32_t cornerCode = rank.corners / 2187;
+	uint32_t edgeCode = (uint32_t)(rank.edges / 2048);
+	int cornerParity = 0;
+	int edgeParity = 0;
+
+	for (int i = 7; i >= 0; --i)
+	{
+		cornerDigits[i] = cornerCode % (8 - i);
+		cornerCode /= 8 - i;
+		cornerParity ^= cornerDigits[i] & 1;
+	}
+
+	edgeDigits[11] = 0;
+
+	for (int i = 9; i >= 0; --i)
+	{
+		edgeDigits[i] = edgeCode % (12 - i);
+		edgeCode /= 12 - i;
+		edgeParity ^= edgeDigits[i] & 1;
+	}
+
+	// The sum of the digits of a Lehmer code is even for even permutations
+	edgeDigits[10] = cornerParity ^ edgeParity;
+
+	SetLehmerPieces<8>(cornerDigits, state.corners.data(), 3);
+	SetLehmerPieces<12>(edgeDigits, state.edges.data(), 2);
+
+	uint32_t twist = rank.corners % 2187;
+	uint32_t flip = (uint32_t)(rank.edges % 2048);
+	int twistSum = 0;
+	int flipSum = 0;
+
+	for (int i = DRB - 1; i >= URF; --i)
+	{
+		state.corners[i] += twist % 3;
+		twistSum += twist % 3;
+		twist /= 3;
+	}
+
+	for (int i = BR - 1; i >= UR; --i)
+	{
+		state.edges[i] += flip % 2;
+		flipSum += flip % 2;
+		flip /= 2;
+	}
+
+	state.corners[DRB] += (3 - twistSum % 3) % 3;
+	state.edges[BR] += flipSum % 2;
+
+	return state;
+}
+
+// Adds one to every lane of smaller where the later row holds a smaller piece than the row
+// Pieces are below 12, so the signed byte comparison works, and a true comparison is all ones, so subtracting it adds one
+static void CountSmallerBatchRow(const uint8_t* row, const uint8_t* laterRow, uint8_t* smaller)
+{
+#if defined(__AVX2__)
+	for (int lane = 0; lane < cubeBatchLanes; lane += 32)
+	{
+		__m256i greater = _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(row + lane)), _mm256_loadu_si256((const __m256i*)(laterRow + lane)));
+		_mm256_storeu_si256((__m256i*)(smaller + lane), _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*)(smaller + lane)), greater));
+	}
+#elif defined(CUBE_BATCH_SSE2)
+	for (int lane = 0; lane < cubeBatchLanes; lane += 16)
+	{
+		__m128i greater = _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(row + lane)), _mm_loadu_si128((const __m128i*)(laterRow + lane)));
+		_mm_storeu_si128((__m128i*)(smaller + lane), _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(smaller + lane)), greater));
+	}
+#else
+	for (int lane = 0; lane < cubeBatchLanes; ++lane)
+	{
+		smaller[lane] += laterRow[lane] < row[lane];
+	}
+#endif
+}
+
+// Multiplies every code by the base and adds the digits of the row
+static void AddBatchDigits(const uint8_t* digits, uint32_t base, uint32_t* codes)
+{
+	for (int lane = 0; lane < cubeBatchLanes; ++lane)
+	{
+		codes[lane] = codes[lane] * base + digits[lane];
+	}
+}
+
+// Ranks every state of a batch with the same codes as RankCubeState
+// The Lehmer digits are counted for 64 states at a time with byte comparisons of whole rows
+// Codes are built in 32 bits, the edge code in a high part of the first five digits and a low part of the rest and the flips
+static void RankCubeStateBatch(const CubeStateBatch& batch, CubeStateRank* ranks)
+{
+	for (int block = 0; block < (int)batch.blocks.size(); ++block)
+	{
+		const CubeStateBlock& states = batch.blocks[block];
+
+		uint32_t cornerCodes[cubeBatchLanes] = {};
+		uint32_t highEdgeCodes[cubeBatchLanes] = {};
+		uint32_t lowEdgeCodes[cubeBatchLanes] = {};
+		uint8_t smaller[cubeBatchLanes];
+
+		for (int i = 0; i < 8; ++i)
+		{
+			memset(smaller, 0, sizeof(smaller));
+
+			for (int j = i + 1; j < 8; ++j)
+			{
+				CountSmallerBatchRow(states.rows[cornerPieceRow + i], states.rows[cornerPieceRow + j], smaller);
+			}
+
+			AddBatchDigits(smaller, 8 - i, cornerCodes);
+		}
+
+		for (int i = 0; i < 10; ++i)
+		{
+			memset(smaller, 0, sizeof(smaller));
+
+			for (int j = i + 1; j < 12; ++j)
+			{
+				CountSmallerBatchRow(states.rows[edgePieceRow + i], states.rows[edgePieceRow + j], smaller);
+			}
+
+			AddBatchDigits(smaller, 12 - i, i < 5 ? highEdgeCodes : lowEdgeCodes);
+		}
+
+		for (int i = URF; i < DRB; ++i)
+		{
+			AddBatchDigits(states.rows[cornerTwistRow + i], 3, cornerCodes);
+		}
+
+		for (int i = UR; i < BR; ++i)
+		{
+			AddBatchDigits(states.rows[edgeFlipRow + i], 2, lowEdgeCodes);
+		}
+
+		// The low part holds the digits with bases 7 down to 3 and the flips
+		const uint64_t lowEdgeCount = 2520 * 2048;
+		int laneCount = batch.size - block * cubeBatchLanes < cubeBatchLanes ? batch.size - block * cubeBatchLanes : cubeBatchLanes;
+
+		for (int lane = 0; lane < laneCount; ++lane)
+		{
+			ranks[block * cubeBatchLanes + lane].corners = cornerCodes[lane];
+			ranks[block * cubeBatchLanes + lane].edges = highEdgeCodes[lane] * lowEdgeCount + lowEdgeCodes[lane];
+		}
+	}
+}
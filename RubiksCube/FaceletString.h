@@ -0,0 +1,290 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "CubeState.h"
+#include "Notation.h"
+#include "PuzzleState.h"
+
+// Reading and writing whole 3x3x3 cube states as 54 facelets, the format most cube tools and scanners share
+// Faces come in the order U R F D L B, each face row by row the way PuzzleState lays them out, and every facelet is named by the face whose centre has its colour
+// The solved cube is UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB
+// Every check looks at a fixed number of facelets, so reading a state costs the same no matter what the state is
+
+static const int faceletCount = 54;
+
+enum FaceletErrors { FACELETSVALID, FACELETLENGTH, FACELETCOLOURS, FACELETCENTRES, FACELETPIECES, FACELETTWIST, FACELETFLIP, FACELETPARITY };
+
+static const char* const faceletErrorMessages[] =
+{
+	"valid",
+	"there have to be exactly 54 facelets",
+	"every colour has to show up 9 times and be one of U, R, F, D, L and B",
+	"the centres have to be in the order U R F D L B",
+	"a corner or edge does not exist or shows up twice",
+	"a corner is twisted",
+	"an edge is flipped",
+	"two pieces are swapped"
+};
+
+// Facelets of every corner and edge slot in the sticker order of CubeState, and the piece and orientation every combination of colours stands for
+// Pieces are stored as in CubeState, piece * 3 + twist for corners and piece * 2 + flip for edges, and combinations no piece has as 255
+struct FaceletTables
+{
+	std::array<std::array<uint8_t, 3>, 8> cornerFacelets;
+	std::array<std::array<uint8_t, 2>, 12> edgeFacelets;
+	std::array<uint8_t, 6 * 6 * 6> cornerColours;
+	std::array<uint8_t, 6 * 6> edgeColours;
+};
+
+// Returns the facelet a slot shows towards the given axis, slot positions are measured in cubies from the centre
+inline int GetSlotFacelet(const int8_t* position, int axis)
+{
+	glm::ivec3 centredPosition = glm::ivec3(position[0], position[1], position[2]) * 2;
+	glm::ivec3 normal = glm::ivec3(0);
+	normal[axis] = position[axis];
+
+	int face = GetCubeFace(normal);
+	int column = (DotProduct(centredPosition, cubeFaceColumns[face]) + 2) / 2;
+	int row = (DotProduct(centredPosition, cubeFaceRows[face]) + 2) / 2;
+
+	return (face * 3 + row) * 3 + column;
+}
+
+inline FaceletTables BuildFaceletTables()
+{
+	FaceletTables tables;
+
+	tables.cornerColours.fill(255);
+	tables.edgeColours.fill(255);
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		for (int sticker = 0; sticker < 3; ++sticker)
+		{
+			tables.cornerFacelets[corner][sticker] = GetSlotFacelet(cornerPositions[corner], GetCornerStickerAxis(corner, sticker));
+		}
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		for (int sticker = 0; sticker < 2; ++sticker)
+		{
+			tables.edgeFacelets[edge][sticker] = GetSlotFacelet(edgePositions[edge], GetEdgeStickerAxis(edge, sticker));
+		}
+	}
+
+	// A piece twisted by t shows its first colour on sticker t, the colours keep their clockwise order
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		for (int twist = 0; twist < 3; ++twist)
+		{
+			int colours[3];
+
+			for (int sticker = 0; sticker < 3; ++sticker)
+			{
+				colours[(sticker + twist) % 3] = tables.cornerFacelets[corner][sticker] / 9;
+			}
+
+			tables.cornerColours[(colours[0] * 6 + colours[1]) * 6 + colours[2]] = corner * 3 + twist;
+		}
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		int first = tables.edgeFacelets[edge][0] / 9;
+		int second = tables.edgeFacelets[edge][1] / 9;
+
+		tables.edgeColours[first * 6 + second] = edge * 2;
+		tables.edgeColours[second * 6 + first] = edge * 2 + 1;
+	}
+
+	return tables;
+}
+
+static const FaceletTables faceletTables = BuildFaceletTables();
+
+// Returns 1 if the permutation needs an odd number of swaps
+inline int GetPermutationParity(const uint8_t* pieces, int count, int divisor)
+{
+	int parity = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		for (int j = i + 1; j < count; ++j)
+		{
+			parity ^= pieces[i] / divisor > pieces[j] / divisor ? 1 : 0;
+		}
+	}
+
+	return parity;
+}
+
+// Reads 54 facelets into a cube state, whitespace around them is ignored
+// Returns FACELETSVALID, or the first check the facelets fail, in which case the state is left unchanged
+inline int ParseFaceletString(const char* text, int length, CubeState& state)
+{
+	while (length > 0 && IsMoveSeparator(text[length - 1]))
+	{
+		--length;
+	}
+
+	while (length > 0 && IsMoveSeparator(text[0]))
+	{
+		++text;
+		--length;
+	}
+
+	if (length != faceletCount)
+	{
+		return FACELETLENGTH;
+	}
+
+	uint8_t colours[faceletCount];
+	int colourCounts[6] = {};
+
+	for (int i = 0; i < faceletCount; ++i)
+	{
+		int colour = GetCubeFaceFromName(text[i]);
+
+		if (colour < 0)
+		{
+			return FACELETCOLOURS;
+		}
+
+		colours[i] = colour;
+		++colourCounts[colour];
+	}
+
+	for (int face = 0; face < 6; ++face)
+	{
+		if (colourCounts[face] != 9)
+		{
+			return FACELETCOLOURS;
+		}
+
+		if (colours[face * 9 + 4] != face)
+		{
+			return FACELETCENTRES;
+		}
+	}
+
+	CubeState result;
+	int foundPieces = 0;
+	int twist = 0;
+	int flip = 0;
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		const std::array<uint8_t, 3>& facelets = faceletTables.cornerFacelets[corner];
+		uint8_t piece = faceletTables.cornerColours[(colours[facelets[0]] * 6 + colours[facelets[1]]) * 6 + colours[facelets[2]]];
+
+		if (piece == 255)
+		{
+			return FACELETPIECES;
+		}
+
+		result.corners[corner] = piece;
+		foundPieces |= 1 << (piece / 3);
+		twist += piece % 3;
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		const std::array<uint8_t, 2>& facelets = faceletTables.edgeFacelets[edge];
+		uint8_t piece = faceletTables.edgeColours[colours[facelets[0]] * 6 + colours[facelets[1]]];
+
+		if (piece == 255)
+		{
+			return FACELETPIECES;
+		}
+
+		result.edges[edge] = piece;
+		foundPieces |= 1 << (8 + piece / 2);
+		flip += piece % 2;
+	}
+
+	// With 9 of every colour and every combination of colours a real piece, a missing piece means another one shows up twice
+	if (foundPieces != (1 << 20) - 1)
+	{
+		return FACELETPIECES;
+	}
+
+	if (twist % 3 != 0)
+	{
+		return FACELETTWIST;
+	}
+
+	if (flip % 2 != 0)
+	{
+		return FACELETFLIP;
+	}
+
+	// A single turn swaps corners and edges an odd number of times each, so both permutations always have the same parity
+	if (GetPermutationParity(result.corners.data(), 8, 3) != GetPermutationParity(result.edges.data(), 12, 2))
+	{
+		return FACELETPARITY;
+	}
+
+	state = result;
+
+	return FACELETSVALID;
+}
+
+inline int ParseFaceletString(const char* text, CubeState& state)
+{
+	return ParseFaceletString(text, (int)strlen(text), state);
+}
+
+// Writes the colour of every facelet, as faces in CubeFaces order
+inline void GetCubeStateFacelets(const CubeState& state, uint8_t* colours)
+{
+	for (int face = 0; face < 6; ++face)
+	{
+		colours[face * 9 + 4] = face;
+	}
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		int piece = state.corners[corner] / 3;
+		int twist = state.corners[corner] % 3;
+
+		for (int sticker = 0; sticker < 3; ++sticker)
+		{
+			colours[faceletTables.cornerFacelets[corner][(sticker + twist) % 3]] = faceletTables.cornerFacelets[piece][sticker] / 9;
+		}
+	}
+
+	for (int edge = 0; edge < 12; ++edge)
+	{
+		int piece = state.edges[edge] / 2;
+		int flip = state.edges[edge] % 2;
+
+		for (int sticker = 0; sticker < 2; ++sticker)
+		{
+			colours[faceletTables.edgeFacelets[edge][(sticker + flip) % 2]] = faceletTables.edgeFacelets[piece][sticker] / 9;
+		}
+	}
+}
+
+// Writes the 54 facelets and a null character, the text has to hold faceletCount + 1 characters
+inline void FormatFaceletString(const CubeState& state, char* text)
+{
+	uint8_t colours[faceletCount];
+	GetCubeStateFacelets(state, colours);
+
+	for (int i = 0; i < faceletCount; ++i)
+	{
+		text[i] = cubeFaceNames[colours[i]];
+	}
+
+	text[faceletCount] = '\0';
+}
+
+// Turns a cube state into the facelets of a 3x3x3 puzzle state, PuzzleState stores its facelets in the same order
+inline void SetPuzzleStateFacelets(const CubeState& state, PuzzleState& puzzleState)
+{
+	puzzleState = PuzzleState(3);
+	GetCubeStateFacelets(state, puzzleState.facelets.data());
+}
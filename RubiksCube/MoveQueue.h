@@ -0,0 +1,221 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Notation.h"
+
+// Fixed capacity first in first out queue for one thread that pushes and one thread that pops
+// Pushing and popping are constant time and never allocate, so pasting a long algorithm costs the same per move as a single key press
+// The two positions only ever grow and wrap around on their own, the capacity has to be a power of two so the index is a mask
+template<typename T, uint32_t Capacity>
+struct RingBuffer
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity of a ring buffer has to be a power of two");
+
+	std::array<T, Capacity> items;
+
+	// Position of the next item to pop, only written by the consumer
+	std::atomic<uint32_t> head{ 0 };
+
+	// Position of the next item to push, only written by the producer
+	std::atomic<uint32_t> tail{ 0 };
+
+	// Returns false if the queue is full, the item is left out then
+	bool Push(const T& item)
+	{
+		uint32_t position = tail.load(std::memory_order_relaxed);
+
+		if (position - head.load(std::memory_order_acquire) == Capacity)
+		{
+			return false;
+		}
+
+		items[position & (Capacity - 1)] = item;
+		tail.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Returns false if the queue is empty
+	bool Pop(T& item)
+	{
+		uint32_t position = head.load(std::memory_order_relaxed);
+
+		if (position == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = items[position & (Capacity - 1)];
+		head.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool Empty() const
+	{
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	uint32_t Size() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+	uint32_t FreeSpace() const
+	{
+		return Capacity - Size();
+	}
+};
+
+// Queue of turns that are waiting to be animated, turns that are still waiting are merged before they are played
+// Turns around one axis commute, so the latest turns around the same axis are kept in a group until a turn around another axis comes in
+// Within the group turns of the same layers are added up, turns that cancel out are dropped and the rest is sorted from one end of the axis to the other
+// The animation only plays what is left, so R R R plays as R', U U' plays nothing and D U plays as U D
+// Every turn is measured in the same frame, which has to stay the same while turns are waiting
+template<uint32_t Capacity>
+struct OptimisingMoveQueue
+{
+	static const int groupCapacity = 16;
+
+	RingBuffer<MoveCode, Capacity> moves;
+
+	// Turns around the axis of the latest turn, measured from the U, R or F end of the axis and sorted by their layers
+	std::array<MoveCode, groupCapacity> group;
+	int groupSize = 0;
+	int groupAxis = 0;
+	int groupCubeSize = 0;
+
+	// Takes turns of explicit layers only, returns false if there is no room left
+	bool Push(MoveCode move, int cubeSize)
+	{
+		int axis = GetMoveFace(move) % 3;
+
+		if (groupSize > 0 && (axis != groupAxis || cubeSize != groupCubeSize || groupSize == groupCapacity))
+		{
+			if (!FlushGroup())
+			{
+				return false;
+			}
+		}
+
+		if (moves.FreeSpace() <= (uint32_t)groupSize)
+		{
+			return false;
+		}
+
+		groupAxis = axis;
+		groupCubeSize = cubeSize;
+
+		MoveCode turn = GetAxisMove(move, cubeSize);
+		int position = 0;
+
+		while (position < groupSize && GetLayerOrder(group[position]) < GetLayerOrder(turn))
+		{
+			++position;
+		}
+
+		if (position < groupSize && GetLayerOrder(group[position]) == GetLayerOrder(turn))
+		{
+			int quarterTurns = (GetMoveQuarterTurns(group[position]) + GetMoveQuarterTurns(turn)) % 4;
+
+			if (quarterTurns == 0)
+			{
+				for (int i = position + 1; i < groupSize; ++i)
+				{
+					group[i - 1] = group[i];
+				}
+
+				--groupSize;
+			}
+			else
+			{
+				group[position] = MakeMoveCode(GetMoveFace(turn), quarterTurns, GetMoveDepth(turn), GetMoveWidth(turn));
+			}
+
+			return true;
+		}
+
+		for (int i = groupSize; i > position; --i)
+		{
+			group[i] = group[i - 1];
+		}
+
+		group[position] = turn;
+		++groupSize;
+
+		return true;
+	}
+
+	// Turns still in the group are only handed out once everything before them is played
+	bool Pop(MoveCode& move)
+	{
+		if (moves.Empty())
+		{
+			FlushGroup();
+		}
+
+		return moves.Pop(move);
+	}
+
+	bool Empty() const
+	{
+		return groupSize == 0 && moves.Empty();
+	}
+
+	uint32_t Size() const
+	{
+		return moves.Size() + groupSize;
+	}
+
+	uint32_t FreeSpace() const
+	{
+		return moves.FreeSpace() - groupSize;
+	}
+
+private:
+
+	// Moves the group into the queue, every turn is turned back into a turn of the face nearest to its layers
+	bool FlushGroup()
+	{
+		if (moves.FreeSpace() < (uint32_t)groupSize)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < groupSize; ++i)
+		{
+			moves.Push(GetNearestFaceMove(group[i], groupCubeSize));
+		}
+
+		groupSize = 0;
+
+		return true;
+	}
+
+	// Layers counted from the far end of the axis belong to the opposite face, which turns the other way
+	static MoveCode GetOppositeFaceMove(MoveCode move, int cubeSize)
+	{
+		int depth = cubeSize - GetMoveDepth(move) - GetMoveWidth(move);
+
+		return MakeMoveCode((GetMoveFace(move) + 3) % 6, 4 - GetMoveQuarterTurns(move), depth, GetMoveWidth(move));
+	}
+
+	static MoveCode GetAxisMove(MoveCode move, int cubeSize)
+	{
+		return GetMoveFace(move) < 3 ? move : GetOppositeFaceMove(move, cubeSize);
+	}
+
+	static MoveCode GetNearestFaceMove(MoveCode move, int cubeSize)
+	{
+		int depth = GetMoveDepth(move);
+
+		return depth > cubeSize - depth - GetMoveWidth(move) ? GetOppositeFaceMove(move, cubeSize) : move;
+	}
+
+	static int GetLayerOrder(MoveCode move)
+	{
+		return GetMoveDepth(move) * (maximumMoveLayers + 1) + GetMoveWidth(move);
+	}
+};
@@ -0,0 +1,418 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+#include "CubeState.h"
+#include "PuzzleState.h"
+
+// Reading and writing moves in the standard notation, like "R U R' U' F2", "Rw", "3Rw", "2R", "M", "E", "S", "x", "y" and "z"
+// Moves are compiled into packed move codes in a buffer the caller owns, so neither reading nor writing ever allocates
+// Faces are named in the order of CubeFaces and are always seen from the viewer, so after a rotation U is whatever face is on top
+
+static const char cubeFaceNames[6] = { 'U', 'R', 'F', 'D', 'L', 'B' };
+
+// How the layers of a move are chosen, inner slices and the whole cube depend on the size of the cube
+enum MoveSpans { LAYERSPAN, INNERSPAN, WHOLESPAN };
+
+// A move packed into 19 bits
+// Bits 0-2 hold the face, 3-4 the clockwise quarter turns, 5-10 the depth of the first layer, 11-16 the number of layers minus one and 17-18 the span
+typedef uint32_t MoveCode;
+
+static const int maximumMoveLayers = 64;
+
+inline MoveCode MakeMoveCode(int face, int quarterTurns, int depth = 0, int width = 1, int span = LAYERSPAN)
+{
+	return face | (quarterTurns & 3) << 3 | depth << 5 | (width - 1) << 11 | span << 17;
+}
+
+inline int GetMoveFace(MoveCode move)
+{
+	return move & 7;
+}
+
+inline int GetMoveQuarterTurns(MoveCode move)
+{
+	return (move >> 3) & 3;
+}
+
+inline int GetMoveDepth(MoveCode move)
+{
+	return (move >> 5) & 63;
+}
+
+inline int GetMoveWidth(MoveCode move)
+{
+	return ((move >> 11) & 63) + 1;
+}
+
+inline int GetMoveSpan(MoveCode move)
+{
+	return (move >> 17) & 3;
+}
+
+// Converts one of the 18 face turns of cubeMoveTable
+inline MoveCode GetCubeMoveCode(int cubeMove)
+{
+	return MakeMoveCode(cubeMove / 3, cubeMove % 3 + 1);
+}
+
+// Returns the first layer and the number of layers the move turns on a cube of the given size
+// M, E and S turn every inner layer, x, y and z every layer
+inline void GetMoveLayers(MoveCode move, int size, int& depth, int& width)
+{
+	switch (GetMoveSpan(move))
+	{
+	case INNERSPAN:
+		depth = 1;
+		width = size - 2;
+		break;
+	case WHOLESPAN:
+		depth = 0;
+		width = size;
+		break;
+	default:
+		depth = GetMoveDepth(move) < size ? GetMoveDepth(move) : size - 1;
+		width = GetMoveWidth(move) < size - depth ? GetMoveWidth(move) : size - depth;
+		break;
+	}
+}
+
+inline bool IsMoveSeparator(char character)
+{
+	return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
+
+inline int GetCubeFaceFromName(char name)
+{
+	for (int face = 0; face < 6; ++face)
+	{
+		if (name == cubeFaceNames[face])
+		{
+			return face;
+		}
+	}
+
+	return -1;
+}
+
+// Compiles whitespace separated moves into the buffer
+// Returns the number of moves, or -1 if a move could not be read or the buffer is too small
+// Turns that cancel out, like R4, are left out
+inline int ParseMoveCodes(const char* text, int length, MoveCode* moves, int capacity)
+{
+	int count = 0;
+	int i = 0;
+
+	while (i < length)
+	{
+		if (IsMoveSeparator(text[i]))
+		{
+			++i;
+			continue;
+		}
+
+		// Layer count in front of the face, as in 3Rw or 2R, or a range of layers, as in 2-3Rw
+		int firstLayer = 0;
+		int layers = 0;
+
+		while (i < length && text[i] >= '0' && text[i] <= '9' && layers <= maximumMoveLayers)
+		{
+			layers = layers * 10 + text[i++] - '0';
+		}
+
+		if (i < length && text[i] == '-' && layers > 0)
+		{
+			firstLayer = layers;
+			layers = 0;
+			++i;
+
+			while (i < length && text[i] >= '0' && text[i] <= '9' && layers <= maximumMoveLayers)
+			{
+				layers = layers * 10 + text[i++] - '0';
+			}
+
+			if (layers < firstLayer)
+			{
+				return -1;
+			}
+		}
+
+		if (i == length || layers > maximumMoveLayers)
+		{
+			return -1;
+		}
+
+		char name = text[i++];
+		int face = GetCubeFaceFromName(name);
+		int depth = 0;
+		int width = 1;
+		int span = LAYERSPAN;
+
+		bool wide = face >= 0 && i < length && text[i] == 'w';
+
+		if (face < 0 && GetCubeFaceFromName(name - 'a' + 'A') >= 0)
+		{
+			face = GetCubeFaceFromName(name - 'a' + 'A');
+			wide = true;
+		}
+		else if (wide)
+		{
+			++i;
+		}
+
+		if (wide)
+		{
+			// Wide turn of the outer layers, two unless counted
+			depth = firstLayer > 0 ? firstLayer - 1 : 0;
+			width = layers > 0 ? layers - depth : 2;
+		}
+		else if (face >= 0 && firstLayer == 0)
+		{
+			// A counted face turns only that one layer
+			depth = layers > 0 ? layers - 1 : 0;
+		}
+		else if (face >= 0 || layers > 0)
+		{
+			return -1;
+		}
+		else
+		{
+			// Slices follow L, D and F, rotations follow R, U and F
+			switch (name)
+			{
+			case 'M': face = LFACE; span = INNERSPAN; break;
+			case 'E': face = DFACE; span = INNERSPAN; break;
+			case 'S': face = FFACE; span = INNERSPAN; break;
+			case 'x': face = RFACE; span = WHOLESPAN; break;
+			case 'y': face = UFACE; span = WHOLESPAN; break;
+			case 'z': face = FFACE; span = WHOLESPAN; break;
+			default: return -1;
+			}
+		}
+
+		if (width < 1 || depth + width > maximumMoveLayers)
+		{
+			return -1;
+		}
+
+		// Number of quarter turns, then ' for counter clockwise, so R2' is read as a half turn
+		int amount = 0;
+		bool counted = false;
+
+		while (i < length && text[i] >= '0' && text[i] <= '9')
+		{
+			amount = (amount * 10 + text[i++] - '0') % 4;
+			counted = true;
+		}
+
+		amount = counted ? amount : 1;
+
+		if (i < length && text[i] == '\'')
+		{
+			amount = (4 - amount) % 4;
+			++i;
+		}
+
+		// Every move has to end at whitespace or the end of the text
+		if (i < length && !IsMoveSeparator(text[i]))
+		{
+			return -1;
+		}
+
+		if (amount != 0)
+		{
+			if (count == capacity)
+			{
+				return -1;
+			}
+
+			moves[count++] = MakeMoveCode(face, amount, depth, width, span);
+		}
+	}
+
+	return count;
+}
+
+inline int ParseMoveCodes(const char* text, MoveCode* moves, int capacity)
+{
+	return ParseMoveCodes(text, (int)strlen(text), moves, capacity);
+}
+
+inline int FormatLayerCount(int layers, char* text, int length)
+{
+	if (layers >= 10)
+	{
+		text[length++] = '0' + layers / 10;
+	}
+
+	text[length++] = '0' + layers % 10;
+
+	return length;
+}
+
+// Writes the moves separated by single spaces and ends the text with a null character
+// Returns the length of the text, or -1 if it does not fit
+inline int FormatMoveCodes(const MoveCode* moves, int count, char* text, int capacity)
+{
+	int length = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		int face = GetMoveFace(moves[i]);
+		int quarterTurns = GetMoveQuarterTurns(moves[i]);
+		int depth = GetMoveDepth(moves[i]);
+		int width = GetMoveWidth(moves[i]);
+		int span = GetMoveSpan(moves[i]);
+
+		// At most " 63-64Rw'"
+		char move[12];
+		int moveLength = 0;
+
+		if (i > 0)
+		{
+			move[moveLength++] = ' ';
+		}
+
+		if (span == LAYERSPAN)
+		{
+			int lastLayer = depth + width;
+
+			if (width > 1 && depth > 0)
+			{
+				moveLength = FormatLayerCount(depth + 1, move, moveLength);
+				move[moveLength++] = '-';
+			}
+
+			if (width > 2 || depth > 0)
+			{
+				moveLength = FormatLayerCount(lastLayer, move, moveLength);
+			}
+
+			move[moveLength++] = cubeFaceNames[face];
+
+			if (width > 1)
+			{
+				move[moveLength++] = 'w';
+			}
+		}
+		else
+		{
+			// Slices and rotations are only named from one side, the other side turns the opposite way
+			static const char* sliceNames = "EMS";
+			static const char* rotationNames = "yxz";
+			bool named = span == INNERSPAN ? (face == LFACE || face == DFACE || face == FFACE) : (face == UFACE || face == RFACE || face == FFACE);
+			int namedFace = named ? face : (face + 3) % 6;
+
+			move[moveLength++] = span == INNERSPAN ? sliceNames[namedFace % 3] : rotationNames[namedFace % 3];
+			quarterTurns = named ? quarterTurns : 4 - quarterTurns;
+		}
+
+		if (quarterTurns == 2)
+		{
+			move[moveLength++] = '2';
+		}
+		else if (quarterTurns == 3)
+		{
+			move[moveLength++] = '\'';
+		}
+
+		if (length + moveLength >= capacity)
+		{
+			return -1;
+		}
+
+		memcpy(text + length, move, moveLength);
+		length += moveLength;
+	}
+
+	if (length >= capacity)
+	{
+		return -1;
+	}
+
+	text[length] = '\0';
+
+	return length;
+}
+
+// Applies a move to an N x N x N cube
+inline void ApplyMoveCode(PuzzleState& puzzleState, MoveCode move)
+{
+	int depth;
+	int width;
+	GetMoveLayers(move, puzzleState.size, depth, width);
+
+	if (width > 0)
+	{
+		puzzleState.ApplyMove(GetMoveFace(move), depth, width, GetMoveQuarterTurns(move));
+	}
+}
+
+// Applies a move to a 3x3x3 cube and keeps its cube state in step
+// The cube state is measured against the centres, so a turn of the middle layer counts as turning both outer layers the other way
+// The puzzle state tells which centre sits on which face, since slices and rotations move them around
+inline void ApplyMoveCode(CubeState& cubeState, PuzzleState& puzzleState, MoveCode move)
+{
+	if (puzzleState.size == 3)
+	{
+		int face = GetMoveFace(move);
+		int depth;
+		int width;
+		GetMoveLayers(move, 3, depth, width);
+
+		int faceCentre = puzzleState.GetFacelet(face, 1, 1);
+		int oppositeCentre = puzzleState.GetFacelet((face + 3) % 6, 1, 1);
+
+		int faceTurns = 0;
+		int oppositeTurns = 0;
+
+		for (int layer = depth; layer < depth + width; ++layer)
+		{
+			switch (layer)
+			{
+			case 0:
+				faceTurns += GetMoveQuarterTurns(move);
+				break;
+			case 1:
+				faceTurns -= GetMoveQuarterTurns(move);
+				oppositeTurns += GetMoveQuarterTurns(move);
+				break;
+			case 2:
+				oppositeTurns -= GetMoveQuarterTurns(move);
+				break;
+			}
+		}
+
+		// Both counts are clockwise turns seen from their own face
+		faceTurns = (faceTurns % 4 + 4) % 4;
+		oppositeTurns = (oppositeTurns % 4 + 4) % 4;
+
+		if (faceTurns != 0)
+		{
+			cubeState.ApplyMove(faceCentre * 3 + faceTurns - 1);
+		}
+
+		if (oppositeTurns != 0)
+		{
+			cubeState.ApplyMove(oppositeCentre * 3 + oppositeTurns - 1);
+		}
+	}
+
+	ApplyMoveCode(puzzleState, move);
+}
+
+// Converts a move of the cube state, which names the face by its centre, into a move of the face that holds that centre now
+inline MoveCode GetCentreMoveCode(const PuzzleState& puzzleState, int cubeMove)
+{
+	int face = cubeMove / 3;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		if (puzzleState.GetFacelet(i, puzzleState.size / 2, puzzleState.size / 2) == cubeMove / 3)
+		{
+			face = i;
+		}
+	}
+
+	return MakeMoveCode(face, cubeMove % 3 + 1);
+}
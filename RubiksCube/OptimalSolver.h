@@ -0,0 +1,481 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CubeState.h"
+#include "PruningTable.h"
+#include "TwoPhaseSolver.h"
+
+// Korf's optimal solver, an IDA* search over the 18 face turns
+// The heuristic is the largest of three pattern databases, which store the exact number of moves needed to solve
+// the corners, the first six edges and the last six edges on their own
+
+// Every corner permutation times every corner orientation
+static const int cornerPatternCount = cornerPermutationCount * twistCount;
+
+// Slots of six edges in order, 12 * 11 * 10 * 9 * 8 * 7, times their flips
+static const int edgePatternEdges = 6;
+static const int edgePatternCount = 665280 * 64;
+
+// Where every edge slot goes with every move, and whether the edge is flipped on the way
+struct EdgeSlotMoves
+{
+	std::array<std::array<uint8_t, 12>, 18> destinations;
+	std::array<std::array<uint8_t, 12>, 18> flips;
+};
+
+static EdgeSlotMoves BuildEdgeSlotMoves()
+{
+	EdgeSlotMoves slotMoves;
+
+	for (int move = 0; move < 18; ++move)
+	{
+		for (int slot = 0; slot < 12; ++slot)
+		{
+			slotMoves.destinations[move][cubeMoveTable[move].edgeSource[slot]] = slot;
+			slotMoves.flips[move][cubeMoveTable[move].edgeSource[slot]] = cubeMoveTable[move].edgeFlip[slot];
+		}
+	}
+
+	return slotMoves;
+}
+
+static const EdgeSlotMoves edgeSlotMoves = BuildEdgeSlotMoves();
+
+// Ranks the slots and flips of six edges, the slots count down from 12 choices for the first edge to 7 for the last
+static int GetEdgePatternIndex(const uint8_t* slots, const uint8_t* flips)
+{
+	int index = 0;
+	int flipBits = 0;
+	int usedSlots = 0;
+
+	for (int i = 0; i < edgePatternEdges; ++i)
+	{
+		int smallerUsed = 0;
+
+		for (int slot = 0; slot < slots[i]; ++slot)
+		{
+			smallerUsed += (usedSlots >> slot) & 1;
+		}
+
+		index = index * (12 - i) + slots[i] - smallerUsed;
+		flipBits = flipBits * 2 + flips[i];
+		usedSlots |= 1 << slots[i];
+	}
+
+	return index * 64 + flipBits;
+}
+
+static void GetEdgePattern(int index, uint8_t* slots, uint8_t* flips)
+{
+	int flipBits = index % 64;
+	index /= 64;
+
+	int digits[edgePatternEdges];
+
+	for (int i = edgePatternEdges - 1; i >= 0; --i)
+	{
+		digits[i] = index % (12 - i);
+		index /= 12 - i;
+		flips[i] = flipBits & 1;
+		flipBits >>= 1;
+	}
+
+	int usedSlots = 0;
+
+	for (int i = 0; i < edgePatternEdges; ++i)
+	{
+		int slot = 0;
+
+		// Picks the unused slot with the given number of unused slots before it
+		for (int unused = digits[i]; unused > 0 || (usedSlots >> slot) & 1; ++slot)
+		{
+			if (!((usedSlots >> slot) & 1))
+			{
+				--unused;
+			}
+		}
+
+		slots[i] = slot;
+		usedSlots |= 1 << slot;
+	}
+}
+
+// Index of the edges firstEdge to firstEdge + 5 of a cube
+static int GetEdgePatternIndex(const CubeState& state, int firstEdge)
+{
+	uint8_t slots[edgePatternEdges];
+	uint8_t flips[edgePatternEdges];
+
+	for (int slot = 0; slot < 12; ++slot)
+	{
+		int edge = state.edges[slot] / 2 - firstEdge;
+
+		if (edge >= 0 && edge < edgePatternEdges)
+		{
+			slots[edge] = slot;
+			flips[edge] = state.edges[slot] % 2;
+		}
+	}
+
+	return GetEdgePatternIndex(slots, flips);
+}
+
+// The three pattern databases, about 86 MB in total, mapped from their files
+struct PatternDatabases
+{
+	std::vector<uint16_t> cornerPermutationMoves;
+	std::vector<uint16_t> twistMoves;
+
+	PruningTable corners;
+	PruningTable firstEdges;
+	PruningTable lastEdges;
+
+	PatternDatabases()
+	{
+		int allMoves[18];
+
+		for (int m = 0; m < 18; ++m)
+		{
+			allMoves[m] = m;
+		}
+
+		cornerPermutationMoves = BuildCoordinateMoveTable(cornerPermutationCount, GetCornerPermutation, allMoves, 18);
+		twistMoves = BuildCoordinateMoveTable(twistCount, GetTwist, allMoves, 18);
+
+		int threadCount = GetDefaultThreadCount();
+
+		auto expandCorners = [this](PatternDatabaseBuilder& builder, int index, int distance)
+		{
+			int permutation = index / twistCount;
+			int twist = index % twistCount;
+			int newEntries = 0;
+
+			for (int move = 0; move < 18; ++move)
+			{
+				newEntries += builder.TrySet(cornerPermutationMoves[permutation * 18 + move] * twistCount + twistMoves[twist * 18 + move], distance);
+			}
+
+			return newEntries;
+		};
+
+		// Both halves of the edges move the same way, only the slots they start in differ
+		auto expandEdges = [](PatternDatabaseBuilder& builder, int index, int distance)
+		{
+			uint8_t slots[edgePatternEdges];
+			uint8_t flips[edgePatternEdges];
+			uint8_t newSlots[edgePatternEdges];
+			uint8_t newFlips[edgePatternEdges];
+			int newEntries = 0;
+
+			GetEdgePattern(index, slots, flips);
+
+			for (int move = 0; move < 18; ++move)
+			{
+				for (int i = 0; i < edgePatternEdges; ++i)
+				{
+					newSlots[i] = edgeSlotMoves.destinations[move][slots[i]];
+					newFlips[i] = flips[i] ^ edgeSlotMoves.flips[move][slots[i]];
+				}
+
+				newEntries += builder.TrySet(GetEdgePatternIndex(newSlots, newFlips), distance);
+			}
+
+			return newEntries;
+		};
+
+		// The databases are read from their files, they are only generated if a file is missing
+		corners = LoadPruningTable("OptimalCorners", 1, (cornerPatternCount + 1) / 2, [&]()
+		{
+			return PatternDatabaseBuilder(cornerPatternCount).Build(0, threadCount, expandCorners);
+		});
+
+		firstEdges = LoadPruningTable("OptimalFirstEdges", 1, (edgePatternCount + 1) / 2, [&]()
+		{
+			return PatternDatabaseBuilder(edgePatternCount).Build(GetEdgePatternIndex(CubeState(), 0), threadCount, expandEdges);
+		});
+
+		lastEdges = LoadPruningTable("OptimalLastEdges", 1, (edgePatternCount + 1) / 2, [&]()
+		{
+			return PatternDatabaseBuilder(edgePatternCount).Build(GetEdgePatternIndex(CubeState(), edgePatternEdges), threadCount, expandEdges);
+		});
+	}
+
+	static int GetEntry(const PruningTable& table, int index)
+	{
+		return (table[index / 2] >> (index % 2 * 4)) & 15;
+	}
+
+	int GetDistance(const CubeState& state) const
+	{
+		int cornerIndex = GetCornerPermutation(state) * twistCount + GetTwist(state);
+
+		int distance = GetEntry(corners, cornerIndex);
+		distance = std::max(distance, GetEntry(firstEdges, GetEdgePatternIndex(state, 0)));
+		distance = std::max(distance, GetEntry(lastEdges, GetEdgePatternIndex(state, edgePatternEdges)));
+
+		return distance;
+	}
+};
+
+// The databases are built the first time an optimal solver needs them and shared by every solver after that
+static const PatternDatabases& GetPatternDatabases()
+{
+	static const PatternDatabases databases;
+
+	return databases;
+}
+
+// A part of the search tree, the moves that lead to it from the cube being solved
+struct SearchTask
+{
+	CubeState state;
+	std::array<int, 2> moves;
+};
+
+// Tasks are handed out round robin, a thread that runs out of its own tasks steals from the back of another thread's queue
+struct WorkStealingQueues
+{
+	std::vector<std::deque<SearchTask>> queues;
+	std::vector<std::unique_ptr<std::mutex>> locks;
+
+	WorkStealingQueues(int threadCount) : queues(threadCount)
+	{
+		for (int i = 0; i < threadCount; ++i)
+		{
+			locks.push_back(std::unique_ptr<std::mutex>(new std::mutex()));
+		}
+	}
+
+	void Push(int thread, const SearchTask& task)
+	{
+		std::lock_guard<std::mutex> lock(*locks[thread]);
+		queues[thread].push_back(task);
+	}
+
+	bool Pop(int thread, SearchTask& task)
+	{
+		for (int i = 0; i < (int)queues.size(); ++i)
+		{
+			int victim = (thread + i) % (int)queues.size();
+			std::lock_guard<std::mutex> lock(*locks[victim]);
+
+			if (queues[victim].empty())
+			{
+				continue;
+			}
+
+			// Own tasks are taken from the front, stolen ones from the back
+			if (victim == thread)
+			{
+				task = queues[victim].front();
+				queues[victim].pop_front();
+			}
+			else
+			{
+				task = queues[victim].back();
+				queues[victim].pop_back();
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+};
+
+// Finds a solution with the fewest possible face turns, returned as indices into cubeMoveTable
+// Every depth limit is searched by all threads together, the tree is split into the 243 sequences of two moves below the root
+struct OptimalSolver
+{
+	const PatternDatabases& databases;
+	int threadCount;
+
+	// Statistics of the last call to Solve
+	int64_t nodeCount = 0;
+	double solveTime = 0.0;
+
+	OptimalSolver(int threadCount = GetDefaultThreadCount()) : databases(GetPatternDatabases())
+	{
+		this->threadCount = std::max(1, threadCount);
+	}
+
+	// Returns an empty solution if the search was cancelled
+	std::vector<int> Solve(const CubeState& state, const std::atomic<bool>* cancel = nullptr)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		nodeCount = 0;
+		solution.clear();
+		found = false;
+		this->cancel = cancel;
+
+		for (int depthLimit = databases.GetDistance(state); !found && !IsCancelled(); ++depthLimit)
+		{
+			if (depthLimit < 2)
+			{
+				std::array<int, 32> path;
+				found = Search(state, path, 0, depthLimit, -1, nodeCount);
+
+				if (found)
+				{
+					solution.assign(path.begin(), path.begin() + depthLimit);
+				}
+			}
+			else
+			{
+				SearchInParallel(state, depthLimit);
+			}
+		}
+
+		solveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (IsCancelled())
+		{
+			solution.clear();
+		}
+
+		return solution;
+	}
+
+	double GetNodesPerSecond() const
+	{
+		return solveTime > 0.0 ? nodeCount / solveTime : 0.0;
+	}
+
+private:
+
+	std::atomic<bool> found;
+	const std::atomic<bool>* cancel = nullptr;
+	std::mutex solutionLock;
+	std::vector<int> solution;
+
+	bool IsCancelled() const
+	{
+		return cancel != nullptr && *cancel;
+	}
+
+	void SearchInParallel(const CubeState& state, int depthLimit)
+	{
+		WorkStealingQueues queues(threadCount);
+		int taskCount = 0;
+
+		for (int first = 0; first < 18; ++first)
+		{
+			for (int second = 0; second < 18; ++second)
+			{
+				if (IsRedundant(second, first))
+				{
+					continue;
+				}
+
+				SearchTask task;
+				task.state = state;
+				task.state.ApplyMove(first);
+				task.state.ApplyMove(second);
+				task.moves = { first, second };
+
+				queues.Push(taskCount++ % threadCount, task);
+			}
+		}
+
+		std::vector<std::thread> threads;
+		std::atomic<int64_t> totalNodes(0);
+
+		for (int thread = 0; thread < threadCount; ++thread)
+		{
+			threads.push_back(std::thread([&, thread]()
+			{
+				std::array<int, 32> path;
+				int64_t threadNodes = 0;
+				SearchTask task;
+
+				while (!found && !IsCancelled() && queues.Pop(thread, task))
+				{
+					path[0] = task.moves[0];
+					path[1] = task.moves[1];
+
+					if (Search(task.state, path, 2, depthLimit - 2, task.moves[1], threadNodes))
+					{
+						std::lock_guard<std::mutex> lock(solutionLock);
+
+						if (!found)
+						{
+							solution.assign(path.begin(), path.begin() + depthLimit);
+							found = true;
+						}
+					}
+				}
+
+				totalNodes += threadNodes;
+			}));
+		}
+
+		for (int thread = 0; thread < threadCount; ++thread)
+		{
+			threads[thread].join();
+		}
+
+		nodeCount += totalNodes;
+	}
+
+	// Moves on the same face are merged, and moves on opposite faces are only tried in one order
+	static bool IsRedundant(int move, int previousMove)
+	{
+		int face = move / 3;
+		int previousFace = previousMove / 3;
+
+		return previousMove >= 0 && (face == previousFace || face + 3 == previousFace);
+	}
+
+	bool Search(const CubeState& state, std::array<int, 32>& path, int depth, int remaining, int previousMove, int64_t& nodes)
+	{
+		++nodes;
+
+		int distance = databases.GetDistance(state);
+
+		if (distance > remaining)
+		{
+			return false;
+		}
+
+		// All three databases are only 0 for the solved cube
+		if (remaining == 0)
+		{
+			return true;
+		}
+
+		// Another thread found a solution of the same length, so this one is not needed
+		if (found || IsCancelled())
+		{
+			return false;
+		}
+
+		for (int move = 0; move < 18; ++move)
+		{
+			if (IsRedundant(move, previousMove))
+			{
+				continue;
+			}
+
+			CubeState next = state;
+			next.ApplyMove(move);
+			path[depth] = move;
+
+			if (Search(next, path, depth + 1, remaining - 1, move, nodes))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
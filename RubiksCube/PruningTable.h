@@ -0,0 +1,408 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Pruning tables are stored in files that are mapped into memory read-only
+// Every process that maps the same file shares the pages through the page cache, and only the pages the search touches are ever read
+// A file starts with a header, the table itself starts on the next page
+
+static const char pruningTableMagic[8] = { 'R', 'C', 'P', 'R', 'U', 'N', 'E', '\0' };
+static const uint32_t pruningTableFormatVersion = 1;
+static const uint64_t pruningTableDataOffset = 4096;
+static const char* pruningTableDirectory = "Tables";
+
+struct PruningTableHeader
+{
+	char magic[8];
+	uint32_t formatVersion;
+
+	// Raised whenever the way a table is generated changes, so old files are rebuilt
+	uint32_t tableVersion;
+
+	uint64_t size;
+	uint64_t checksum;
+	char name[32];
+};
+
+// When set, the checksum of every table is checked when it is loaded, which reads the whole file
+// Otherwise only the header is checked, so loading stays fast no matter how large the tables are
+static bool verifyPruningTableChecksums = false;
+
+// 64 bit FNV-1a over 8 bytes at a time
+static uint64_t GetPruningTableChecksum(const uint8_t* data, uint64_t size)
+{
+	uint64_t checksum = 14695981039346656037ull;
+	uint64_t i = 0;
+
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, data + i, 8);
+
+		checksum = (checksum ^ word) * 1099511628211ull;
+	}
+
+	for (; i < size; ++i)
+	{
+		checksum = (checksum ^ data[i]) * 1099511628211ull;
+	}
+
+	return checksum;
+}
+
+// A whole file mapped into memory read-only
+struct MappedFile
+{
+	const uint8_t* data = nullptr;
+	uint64_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+#else
+	int descriptor = -1;
+#endif
+
+	MappedFile()
+	{
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile()
+	{
+		Close();
+	}
+
+	bool Open(const std::string& path)
+	{
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+		LARGE_INTEGER fileSize;
+
+		if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		size = fileSize.QuadPart;
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		data = mapping != NULL ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+		descriptor = open(path.c_str(), O_RDONLY);
+
+		struct stat fileStatus;
+
+		if (descriptor < 0 || fstat(descriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+
+		size = fileStatus.st_size;
+		void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+		data = address != MAP_FAILED ? (const uint8_t*)address : nullptr;
+#endif
+
+		if (data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void Close()
+	{
+#ifdef _WIN32
+		if (data != nullptr)
+		{
+			UnmapViewOfFile(data);
+		}
+
+		if (mapping != NULL)
+		{
+			CloseHandle(mapping);
+		}
+
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file);
+		}
+
+		mapping = NULL;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (data != nullptr)
+		{
+			munmap((void*)data, size);
+		}
+
+		if (descriptor >= 0)
+		{
+			close(descriptor);
+		}
+
+		descriptor = -1;
+#endif
+
+		data = nullptr;
+		size = 0;
+	}
+};
+
+// A read-only table of bytes, mapped from its file or, if the file could not be written, kept in memory
+struct PruningTable
+{
+	const uint8_t* data = nullptr;
+	uint64_t size = 0;
+
+	std::unique_ptr<MappedFile> file;
+	std::vector<uint8_t> memory;
+
+	uint8_t operator[](uint64_t index) const
+	{
+		return data[index];
+	}
+};
+
+static std::string GetPruningTablePath(const std::string& name)
+{
+	return std::string(pruningTableDirectory) + "/" + name + ".prune";
+}
+
+// Maps the table file and checks that it belongs to this table, returns nullptr if it does not
+static std::unique_ptr<MappedFile> MapPruningTable(const std::string& name, uint32_t tableVersion, uint64_t size)
+{
+	std::unique_ptr<MappedFile> file(new MappedFile());
+
+	if (!file->Open(GetPruningTablePath(name)) || file->size != pruningTableDataOffset + size)
+	{
+		return nullptr;
+	}
+
+	PruningTableHeader header;
+	memcpy(&header, file->data, sizeof(header));
+
+	if (memcmp(header.magic, pruningTableMagic, sizeof(header.magic)) != 0 || header.formatVersion != pruningTableFormatVersion ||
+		header.tableVersion != tableVersion || header.size != size || strncmp(header.name, name.c_str(), sizeof(header.name)) != 0)
+	{
+		return nullptr;
+	}
+
+	if (verifyPruningTableChecksums && GetPruningTableChecksum(file->data + pruningTableDataOffset, size) != header.checksum)
+	{
+		std::cout << "Pruning table " << name << " is damaged" << std::endl;
+
+		return nullptr;
+	}
+
+	return file;
+}
+
+// Writes the table to a temporary file first and renames it at the end, so other processes never map a half written table
+static bool WritePruningTable(const std::string& name, uint32_t tableVersion, const std::vector<uint8_t>& table)
+{
+#ifdef _WIN32
+	_mkdir(pruningTableDirectory);
+#else
+	mkdir(pruningTableDirectory, 0755);
+#endif
+
+	PruningTableHeader header = {};
+	memcpy(header.magic, pruningTableMagic, sizeof(header.magic));
+	header.formatVersion = pruningTableFormatVersion;
+	header.tableVersion = tableVersion;
+	header.size = table.size();
+	header.checksum = GetPruningTableChecksum(table.data(), table.size());
+	memcpy(header.name, name.c_str(), std::min(name.size(), sizeof(header.name) - 1));
+
+	std::string path = GetPruningTablePath(name);
+	std::string temporaryPath = path + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+
+	std::vector<char> headerPage(pruningTableDataOffset, 0);
+	memcpy(headerPage.data(), &header, sizeof(header));
+
+	std::ofstream file(temporaryPath, std::ios::binary);
+	file.write(headerPage.data(), headerPage.size());
+	file.write((const char*)table.data(), table.size());
+	file.close();
+
+	bool written = !file.fail();
+
+	if (written)
+	{
+		remove(path.c_str());
+		written = rename(temporaryPath.c_str(), path.c_str()) == 0;
+	}
+
+	if (!written)
+	{
+		remove(temporaryPath.c_str());
+	}
+
+	return written;
+}
+
+// Maps the table from its file, the file is generated first if it is missing, out of date or damaged
+// build is only called in that case, so every table is generated once and then shared by every run that follows
+template<typename Build>
+static PruningTable LoadPruningTable(const std::string& name, uint32_t tableVersion, uint64_t size, Build build)
+{
+	PruningTable table;
+	table.file = MapPruningTable(name, tableVersion, size);
+
+	if (table.file == nullptr)
+	{
+		std::cout << "Generating pruning table " << name << "..." << std::endl;
+
+		std::vector<uint8_t> memory = build();
+
+		if (WritePruningTable(name, tableVersion, memory))
+		{
+			table.file = MapPruningTable(name, tableVersion, size);
+		}
+
+		if (table.file == nullptr)
+		{
+			table.memory = std::move(memory);
+		}
+	}
+
+	table.data = table.file != nullptr ? table.file->data + pruningTableDataOffset : table.memory.data();
+	table.size = size;
+
+	return table;
+}
+
+// Distances packed two to a byte, 15 marks an entry that has not been reached yet
+// Every thread fills its own share of each depth, the bytes are atomic so two threads can reach neighbouring entries at once
+struct PatternDatabaseBuilder
+{
+	std::unique_ptr<std::atomic<uint8_t>[]> bytes;
+	int size;
+
+	PatternDatabaseBuilder(int size)
+	{
+		this->size = size;
+		bytes.reset(new std::atomic<uint8_t>[(size + 1) / 2]);
+
+		for (int i = 0; i < (size + 1) / 2; ++i)
+		{
+			bytes[i].store(0xFF, std::memory_order_relaxed);
+		}
+	}
+
+	int Get(int index) const
+	{
+		return (bytes[index / 2].load(std::memory_order_relaxed) >> (index % 2 * 4)) & 15;
+	}
+
+	// Sets an entry that has not been reached yet, returns false if another thread got there first
+	bool TrySet(int index, int distance)
+	{
+		std::atomic<uint8_t>& byte = bytes[index / 2];
+		int shift = index % 2 * 4;
+		uint8_t oldByte = byte.load(std::memory_order_relaxed);
+
+		while (((oldByte >> shift) & 15) == 15)
+		{
+			uint8_t newByte = (oldByte & ~(15 << shift)) | (distance << shift);
+
+			if (byte.compare_exchange_weak(oldByte, newByte, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Breadth first search from the entry of the solved cube, expand fills the neighbours of one entry and returns how many were new
+	template<typename Expand>
+	std::vector<uint8_t> Build(int solvedIndex, int threadCount, Expand expand)
+	{
+		TrySet(solvedIndex, 0);
+		int64_t reached = 1;
+
+		for (int depth = 0; reached < size; ++depth)
+		{
+			std::atomic<int64_t> newlyReached(0);
+			std::vector<std::thread> threads;
+
+			for (int thread = 0; thread < threadCount; ++thread)
+			{
+				threads.push_back(std::thread([&, thread]()
+				{
+					int64_t threadReached = 0;
+
+					for (int index = (int)((int64_t)size * thread / threadCount); index < (int64_t)size * (thread + 1) / threadCount; ++index)
+					{
+						if (Get(index) == depth)
+						{
+							threadReached += expand(*this, index, depth + 1);
+						}
+					}
+
+					newlyReached += threadReached;
+				}));
+			}
+
+			for (int thread = 0; thread < threadCount; ++thread)
+			{
+				threads[thread].join();
+			}
+
+			if (newlyReached == 0)
+			{
+				break;
+			}
+
+			reached += newlyReached;
+		}
+
+		std::vector<uint8_t> table((size + 1) / 2);
+
+		for (size_t i = 0; i < table.size(); ++i)
+		{
+			table[i] = bytes[i].load(std::memory_order_relaxed);
+		}
+
+		return table;
+	}
+};
+
+static int GetDefaultThreadCount()
+{
+	return std::max(1, (int)std::thread::hardware_concurrency());
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "CubeState.h"
+
+// Outward normal, and the directions in which columns and rows grow, for every face in CubeFaces order
+// Faces are laid out the usual way: U seen from above with B at the top, D seen from below with F at the top, the four sides with U at the top
+static const glm::ivec3 cubeFaceNormals[6] = { glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, -1, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, -1) };
+static const glm::ivec3 cubeFaceColumns[6] = { glm::ivec3(1, 0, 0), glm::ivec3(0, 0, -1), glm::ivec3(1, 0, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(-1, 0, 0) };
+static const glm::ivec3 cubeFaceRows[6] = { glm::ivec3(0, 0, 1), glm::ivec3(0, -1, 0), glm::ivec3(0, -1, 0), glm::ivec3(0, 0, -1), glm::ivec3(0, -1, 0), glm::ivec3(0, -1, 0) };
+
+static int DotProduct(glm::ivec3 a, glm::ivec3 b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Returns the face in CubeFaces order that has the given outward normal
+static int GetCubeFace(glm::ivec3 normal)
+{
+	for (int face = 0; face < 6; ++face)
+	{
+		if (cubeFaceNormals[face] == normal)
+		{
+			return face;
+		}
+	}
+
+	return UFACE;
+}
+
+// Render independent state of an N x N x N cube, stored as the colour of every facelet
+// Memory grows with the 6 * N * N facelets on the surface, the inside of the cube is never stored
+// Positions are measured in half cubies from the centre of the cube, so a cubie centre on an outer layer sits at N - 1
+struct PuzzleState
+{
+	int size = 3;
+	std::vector<uint8_t> facelets;
+
+	// Reused by every move, reserved in the constructor for a turn of the whole cube, which moves every facelet
+	// No move touches more facelets, so applying one never allocates
+	std::vector<uint32_t> moveSources;
+	std::vector<uint32_t> moveTargets;
+	std::vector<uint8_t> moveColours;
+
+	PuzzleState(int size = 3)
+	{
+		this->size = size;
+
+		facelets.resize(6 * size * size);
+		moveSources.reserve(facelets.size());
+		moveTargets.reserve(facelets.size());
+		moveColours.reserve(facelets.size());
+
+		Reset();
+	}
+
+	// Back to the solved cube, without allocating
+	void Reset()
+	{
+		for (size_t i = 0; i < facelets.size(); ++i)
+		{
+			facelets[i] = i / (size * size);
+		}
+	}
+
+	int GetFaceletIndex(int face, int row, int column) const
+	{
+		return (face * size + row) * size + column;
+	}
+
+	uint8_t GetFacelet(int face, int row, int column) const
+	{
+		return facelets[GetFaceletIndex(face, row, column)];
+	}
+
+	// Turns layers of the cube, measured from a face
+	// depth 0 is the outer layer, width is the number of layers turned together and quarterTurns counts clockwise turns seen from the face
+	void ApplyMove(int face, int depth, int width, int quarterTurns)
+	{
+		moveSources.clear();
+		moveTargets.clear();
+
+		for (int layer = depth; layer < depth + width && layer < size; ++layer)
+		{
+			CollectLayer(cubeFaceNormals[face], size - 1 - 2 * layer, quarterTurns);
+		}
+
+		moveColours.resize(moveSources.size());
+
+		for (size_t i = 0; i < moveSources.size(); ++i)
+		{
+			moveColours[i] = facelets[moveSources[i]];
+		}
+
+		for (size_t i = 0; i < moveTargets.size(); ++i)
+		{
+			facelets[moveTargets[i]] = moveColours[i];
+		}
+	}
+
+	bool IsSolved() const
+	{
+		for (size_t i = 0; i < facelets.size(); ++i)
+		{
+			if (facelets[i] != facelets[i / (size * size) * size * size])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+private:
+
+	// Adds every facelet of the layer at the given height along the axis, and where the turn takes it
+	void CollectLayer(glm::ivec3 axis, int height, int quarterTurns)
+	{
+		for (int face = 0; face < 6; ++face)
+		{
+			int facing = DotProduct(cubeFaceNormals[face], axis);
+			int columnFacing = DotProduct(cubeFaceColumns[face], axis);
+			int rowFacing = DotProduct(cubeFaceRows[face], axis);
+
+			if (facing != 0)
+			{
+				if (facing * (size - 1) == height)
+				{
+					for (int row = 0; row < size; ++row)
+					{
+						for (int column = 0; column < size; ++column)
+						{
+							CollectFacelet(face, row, column, axis, quarterTurns);
+						}
+					}
+				}
+			}
+			else if (columnFacing != 0)
+			{
+				int column = (height * columnFacing + size - 1) / 2;
+
+				for (int row = 0; row < size; ++row)
+				{
+					CollectFacelet(face, row, column, axis, quarterTurns);
+				}
+			}
+			else if (rowFacing != 0)
+			{
+				int row = (height * rowFacing + size - 1) / 2;
+
+				for (int column = 0; column < size; ++column)
+				{
+					CollectFacelet(face, row, column, axis, quarterTurns);
+				}
+			}
+		}
+	}
+
+	// Rotates the facelet clockwise around the axis, seen from the end the axis points to, and records where it lands
+	void CollectFacelet(int face, int row, int column, glm::ivec3 axis, int quarterTurns)
+	{
+		glm::ivec3 position = cubeFaceNormals[face] * (size - 1) + cubeFaceColumns[face] * (2 * column - size + 1) + cubeFaceRows[face] * (2 * row - size + 1);
+		glm::ivec3 normal = cubeFaceNormals[face];
+
+		for (int i = 0; i < quarterTurns; ++i)
+		{
+			position = RotateClockwise(position, axis);
+			normal = RotateClockwise(normal, axis);
+		}
+
+		int targetFace = GetCubeFace(normal);
+		int targetColumn = (DotProduct(position, cubeFaceColumns[targetFace]) + size - 1) / 2;
+		int targetRow = (DotProduct(position, cubeFaceRows[targetFace]) + size - 1) / 2;
+
+		moveSources.push_back(GetFaceletIndex(face, row, column));
+		moveTargets.push_back(GetFaceletIndex(targetFace, targetRow, targetColumn));
+	}
+
+	static glm::ivec3 RotateClockwise(glm::ivec3 vector, glm::ivec3 axis)
+	{
+		glm::ivec3 cross = glm::ivec3(axis.y * vector.z - axis.z * vector.y, axis.z * vector.x - axis.x * vector.z, axis.x * vector.y - axis.y * vector.x);
+
+		return axis * DotProduct(axis, vector) - cross;
+	}
+};
@@ -0,0 +1,253 @@
+#pragma once
+#include <cstdint>
+
+// The rotation group of the cube, built entirely at compile time
+// Every question about orientations, chaining two of them, undoing one or finding where a face ends up, is a single table lookup
+
+// One of the 24 rotations that map the cube onto itself, stored as an exact integer matrix
+struct CubeRotation
+{
+	int8_t matrix[3][3];
+
+	constexpr bool operator==(const CubeRotation& other) const
+	{
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 3; ++column)
+			{
+				if (matrix[row][column] != other.matrix[row][column])
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+};
+
+// Outward normals of the faces in CubeFaces order, U R F D L B
+static constexpr int8_t rotationFaceNormals[6][3] = { { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 }, { -1, 0, 0 }, { 0, 0, -1 } };
+
+// The rotation group of the cube with its tables, elements are indices into rotations
+struct RotationGroup
+{
+	CubeRotation rotations[24];
+
+	// The element reached by quarter turns around the world x, y or z axis, counter clockwise seen from the positive end
+	uint8_t quarterTurns[24][3][4];
+
+	// multiplication[a][b] turns like b first and then like a
+	uint8_t multiplication[24][24];
+	uint8_t inverses[24];
+
+	// Which face of the cube points along each face normal of the world while the cube is held in the orientation, and the other way round
+	uint8_t worldToCubeFaces[24][6];
+	uint8_t cubeToWorldFaces[24][6];
+
+	// The 18 face turns, ordered like cubeMoveTable, of the world as turns of the cube held in the orientation, R^-1 * move * R
+	// The table of the inverse element translates turns of the cube back into turns of the world
+	uint8_t conjugateMoves[24][18];
+};
+
+// Returns the counter clockwise quarter turn around the x, y or z axis
+static constexpr CubeRotation GetQuarterTurn(int axis)
+{
+	CubeRotation quarterTurn = {};
+
+	int u = (axis + 1) % 3;
+	int v = (axis + 2) % 3;
+
+	quarterTurn.matrix[axis][axis] = 1;
+	quarterTurn.matrix[u][v] = -1;
+	quarterTurn.matrix[v][u] = 1;
+
+	return quarterTurn;
+}
+
+// Returns the rotation that applies second after first
+static constexpr CubeRotation MultiplyRotations(const CubeRotation& second, const CubeRotation& first)
+{
+	CubeRotation result = {};
+
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 3; ++column)
+		{
+			int sum = 0;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				sum += second.matrix[row][k] * first.matrix[k][column];
+			}
+
+			result.matrix[row][column] = sum;
+		}
+	}
+
+	return result;
+}
+
+// Every row of a rotation has one entry of 1 or -1, its column and sign give 3 bits per row
+static constexpr int GetRotationKey(const CubeRotation& rotation)
+{
+	int key = 0;
+
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 3; ++column)
+		{
+			if (rotation.matrix[row][column] != 0)
+			{
+				key |= (column * 2 + (rotation.matrix[row][column] < 0 ? 1 : 0)) << (row * 3);
+			}
+		}
+	}
+
+	return key;
+}
+
+// Returns the face whose outward normal the vector is
+static constexpr int GetRotationFace(int x, int y, int z)
+{
+	for (int face = 0; face < 6; ++face)
+	{
+		if (rotationFaceNormals[face][0] == x && rotationFaceNormals[face][1] == y && rotationFaceNormals[face][2] == z)
+		{
+			return face;
+		}
+	}
+
+	return 0;
+}
+
+// Generates all 24 rotations from the identity by applying quarter turns until no new rotation shows up, the identity is always element 0
+// Every new element is a quarter turn of an older one, so the products follow from the quarter turn table without multiplying matrices
+static constexpr RotationGroup BuildRotationGroup()
+{
+	RotationGroup group = {};
+
+	// Element index + 1 for every key that was found, 0 for the others
+	uint8_t keyIndices[512] = {};
+	uint8_t parents[24] = {};
+	uint8_t parentAxes[24] = {};
+
+	CubeRotation identity = {};
+	identity.matrix[0][0] = identity.matrix[1][1] = identity.matrix[2][2] = 1;
+
+	group.rotations[0] = identity;
+	keyIndices[GetRotationKey(identity)] = 1;
+	int rotationCount = 1;
+
+	for (int i = 0; i < rotationCount; ++i)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			CubeRotation rotation = group.rotations[i];
+			int previous = i;
+
+			for (int turns = 0; turns < 4; ++turns)
+			{
+				int key = GetRotationKey(rotation);
+
+				if (keyIndices[key] == 0)
+				{
+					group.rotations[rotationCount] = rotation;
+					parents[rotationCount] = previous;
+					parentAxes[rotationCount] = axis;
+					keyIndices[key] = ++rotationCount;
+				}
+
+				group.quarterTurns[i][axis][turns] = keyIndices[key] - 1;
+				previous = keyIndices[key] - 1;
+
+				rotation = MultiplyRotations(GetQuarterTurn(axis), rotation);
+			}
+		}
+	}
+
+	// Element a is a quarter turn of its parent, so a * b is that quarter turn of parent * b
+	for (int b = 0; b < 24; ++b)
+	{
+		group.multiplication[0][b] = b;
+	}
+
+	for (int a = 1; a < 24; ++a)
+	{
+		for (int b = 0; b < 24; ++b)
+		{
+			group.multiplication[a][b] = group.quarterTurns[group.multiplication[parents[a]][b]][parentAxes[a]][1];
+
+			if (group.multiplication[a][b] == 0)
+			{
+				group.inverses[a] = b;
+			}
+		}
+	}
+
+	for (int r = 0; r < 24; ++r)
+	{
+		const CubeRotation& rotation = group.rotations[r];
+
+		for (int face = 0; face < 6; ++face)
+		{
+			const int8_t* normal = rotationFaceNormals[face];
+			int cubeNormal[3] = {};
+			int worldNormal[3] = {};
+
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 3; ++column)
+				{
+					cubeNormal[column] += rotation.matrix[row][column] * normal[row];
+					worldNormal[row] += rotation.matrix[row][column] * normal[column];
+				}
+			}
+
+			group.worldToCubeFaces[r][face] = GetRotationFace(cubeNormal[0], cubeNormal[1], cubeNormal[2]);
+			group.cubeToWorldFaces[r][face] = GetRotationFace(worldNormal[0], worldNormal[1], worldNormal[2]);
+		}
+
+		// Rotations keep the sense of a turn, only the face changes
+		for (int move = 0; move < 18; ++move)
+		{
+			group.conjugateMoves[r][move] = group.worldToCubeFaces[r][move / 3] * 3 + move % 3;
+		}
+	}
+
+	return group;
+}
+
+static constexpr RotationGroup rotationGroup = BuildRotationGroup();
+
+// Checks the tables against the group laws once, while compiling
+static constexpr bool IsRotationGroupValid(const RotationGroup& group)
+{
+	for (int a = 0; a < 24; ++a)
+	{
+		if (group.multiplication[a][group.inverses[a]] != 0 || group.multiplication[group.inverses[a]][a] != 0)
+		{
+			return false;
+		}
+
+		for (int b = 0; b < 24; ++b)
+		{
+			if (!(group.rotations[group.multiplication[a][b]] == MultiplyRotations(group.rotations[a], group.rotations[b])))
+			{
+				return false;
+			}
+		}
+
+		for (int face = 0; face < 6; ++face)
+		{
+			if (group.cubeToWorldFaces[a][group.worldToCubeFaces[a][face]] != face)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static_assert(IsRotationGroupValid(rotationGroup), "The rotation group tables do not form a group");
@@ -1,55 +1,115 @@
 #include <iostream>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <future>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
-#include <glm/gtx/matrix_decompose.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include <irrKlang/irrKlang.h>
 
 #include "Shader.h"
 #include "RubiksCube.h"
 #include "CameraController.h"
+#include "CubeState.h"
+#include "FaceletString.h"
+#include "MoveQueue.h"
+#include "Notation.h"
+#include "OptimalSolver.h"
+#include "PuzzleState.h"
+#include "SolverBenchmark.h"
+#include "TwoPhaseSolver.h"
+
+#ifdef ALLOCATION_BENCHMARK
+#include "AllocationBenchmark.h"
+#endif
 
 GLFWwindow *window;
 
 const GLuint screenWidth = 1600;
 const GLuint screenHeight = 900;
 
-GLuint rubiksCubeTexture;
-GLuint blanktTileTexture;
+GLuint stickerTextures;
 GLuint skyboxTextures;
 
+// Index into stickerThemes
+int stickerTheme = 0;
+
 GLuint rubiksCubeVAO;
 GLuint rubiksCubeVBO;
+GLuint rubiksCubeEBO;
+GLuint cubieModelVBO;
+GLuint cubieColourVBO;
 GLuint skyboxVAO;
 GLuint skyboxVBO;
 
 Shader *lightingShader = nullptr;
 Shader *skyboxShader = nullptr;
+LightingShaderUniforms lightingUniforms;
+SkyboxShaderUniforms skyboxUniforms;
+
+GLuint lightsUBO;
+GLuint cameraUBO;
+
+// Camera data that was uploaded last, the camera block is only written again when it changes
+CameraBlock uploadedCamera;
 
 CameraController camera(glm::vec3(0, 0, 0));
 
-std::vector<TurnMove*> currentMove = {};
-std::vector<std::array<int, 5>> moveQueue = {};
+AnimationSlot currentMove;
+// Turns waiting to be animated, in the frame of the world so the face of a move is the one on screen
+// Turns that are still waiting are merged, so the animation only plays the shortest sequence that ends in the same state
+OptimisingMoveQueue<moveQueueCapacity> moveQueue;
+
+// Number of cubies along each edge of the cube
+int cubeSize = 3;
+
+// Logical state of the cube, always includes every move in the queue
+// The cubies below only animate towards it, cubeState is only kept for the 3x3x3 cube
+PuzzleState puzzleState;
+CubeState cubeState;
+
+// Optimal solutions can take a long time, so they are searched on another thread and queued once they are ready
+// The solution is only used if the cube has not been turned in the meantime
+std::future<std::vector<int>> optimalSolution;
+CubeState optimalSolutionState;
+std::atomic<bool> cancelOptimalSolution(false);
+
+// Rotation of the whole cube in the world, one of the 24 elements of the rotation group
+uint8_t cubeOrientation = 0;
+
+// Inner layer picked with the number keys, used by the next turn
+int selectedLayer = 0;
+
 
 using namespace irrklang;
+
+// The allocation benchmark runs without a sound device, the sounds are skipped when there is none
+#ifdef ALLOCATION_BENCHMARK
+ISoundEngine* SoundEngine = nullptr;
+#else
 ISoundEngine* SoundEngine = createIrrKlangDevice();
+#endif
+
+void PlaySoundEffect(const char* soundFile)
+{
+	if (SoundEngine != nullptr)
+	{
+		SoundEngine->play2D(soundFile);
+	}
+}
 
 bool freeCam = false;
 bool firstMouseInput = true;
 float lastX = screenWidth / 2.0f;
 float lastY = screenHeight / 2.0f;
 
-int rubiksCubeXAxis = XAXIS;
-int rubiksCubeYAxis = YAXIS;
-int rubiksCubeZAxis = ZAXIS;
-
-int topFace = WHITEFACE;
-int frontFace = BLUEFACE;
-
 float deltaTime = 0.0f;
 float animationAngle = 0.0f;
 
@@ -66,131 +126,207 @@ bool downArrowPressed = false;
 bool rightArrowPressed = false;
 
 bool fKeyPressed = false;
-
-// Defines a single cubie that is used to build the whole cube
-// Colours, positions and what sides need to be textured are defined here
-class Cubie
+bool enterKeyPressed = false;
+bool vKeyPressed = false;
+bool cKeyPressed = false;
+bool tKeyPressed = false;
+
+// Stores every cubie of the cube as a structure of arrays, a cubie is an index into these arrays
+// Updating and drawing the cube are linear passes over contiguous memory instead of walking a tree of heap objects
+// Only the cubies on the surface are stored, so memory grows with N * N instead of N * N * N
+struct CubieStore
 {
-public:
+	std::vector<glm::mat4> models;
+	std::array<std::vector<uint8_t>, 3> coordinates;
+	std::vector<uint8_t> orientations;
+	std::vector<std::array<uint8_t, 6>> colours;
 
-	std::vector<glm::vec3> colors;
-	glm::vec3 cubiePosition = glm::vec3(0.0f, 0.0f, 0.0f);
-	std::array<bool, 6> visible = {};
-	std::vector<Cubie*> cubies = {};
-	glm::mat4 cubieTransformationMatrix = glm::mat4(1.0f);
+	// Indices of the cubies that take part in the current move
+	std::vector<uint32_t> movingCubies;
 
+	// Set when the arrays have to be uploaded to the instance buffers again before the next draw
+	bool coloursChanged = true;
+	bool modelsChanged = true;
 
-	Cubie(std::vector<glm::vec3> colors, std::array<bool, 6> visible, glm::vec3 cubiePosition)
+	int Size() const
 	{
-		this->colors = colors;
-		this->cubiePosition = cubiePosition;
-		this->visible = visible;
-		this->cubieTransformationMatrix = glm::translate(this->cubieTransformationMatrix, this->cubiePosition);
+		return (int)orientations.size();
 	}
 
-	// Draws the individual cubie and applies the lighting shader
-	void DrawCubie(Shader* lightingShader)
+	void Clear()
 	{
-		float diffuseMultiplier = 1.50f;
-		float ambientMultiplier = 1.0f * diffuseMultiplier;
-
-		lightingShader->Use();
-
-		glm::mat4 lightingShaderModel = glm::mat4(1.0f);
-		lightingShaderModel *= this->cubieTransformationMatrix;
+		models.clear();
+		orientations.clear();
+		colours.clear();
+		movingCubies.clear();
 
-		lightingShader->SetMatrix3("normal", glm::inverse(lightingShaderModel));
-		lightingShader->SetMatrix4("model", lightingShaderModel);
+		coloursChanged = true;
+		modelsChanged = true;
 
-		for (int i = 0; i < 6; ++i)
+		for (int axis = 0; axis < 3; ++axis)
 		{
-			if (visible[i] == true)
-			{
-				glBindTexture(GL_TEXTURE_2D, rubiksCubeTexture);
-			}
-			else
-			{
-				glBindTexture(GL_TEXTURE_2D, blanktTileTexture);
-			}
-
-			lightingShader->SetVector3("material.ambient", this->colors[i][0] * ambientMultiplier, this->colors[i][1] * ambientMultiplier, this->colors[i][2] * ambientMultiplier);
-			lightingShader->SetVector3("material.diffuse", this->colors[i][0] * diffuseMultiplier, this->colors[i][1] * diffuseMultiplier, this->colors[i][2] * diffuseMultiplier);
-
-			glDrawArrays(GL_TRIANGLES, 6 * i, 6);
+			coordinates[axis].clear();
 		}
+	}
 
-		for (int i = 0; i < cubies.size(); ++i)
+	// Adds a cubie at a lattice position, the colours of its six sides are indices into cubieColours
+	void AddCubie(glm::ivec3 position, std::array<uint8_t, 6> cubieColours)
+	{
+		for (int axis = 0; axis < 3; ++axis)
 		{
-			cubies[i]->DrawCubie(lightingShader);
+			coordinates[axis].push_back(position[axis]);
 		}
+
+		orientations.push_back(0);
+		colours.push_back(cubieColours);
+		models.push_back(GetRestingMatrix(Size() - 1));
 	}
 
-	// Used to rotate the cubes when a move is executed
-	// The matrix is then decomposed to get the updated cubie positions
-	void Rotate(glm::mat4 transformationMatrix, float rotationAngle, glm::vec3 cubieAxis, glm::vec3 worldAxis)
+	// Builds the matrix of a cubie from its lattice position and orientation, both are exact so no error can build up
+	// The cube is scaled so it always takes up the same space as a 3x3x3 cube
+	glm::mat4 GetRestingMatrix(int cubie) const
 	{
-		glm::vec3 scale;
-		glm::quat orientation;
-		glm::vec3 skew;
-		glm::vec4 perspective;
+		float centre = (cubeSize - 1) / 2.0f;
+		glm::vec3 position = glm::vec3(coordinates[XAXIS][cubie], coordinates[YAXIS][cubie], coordinates[ZAXIS][cubie]) - centre;
 
-		glm::mat4 rotationQuaternion = glm::rotate(glm::mat4(1.0f), glm::radians(rotationAngle), worldAxis);
-		glm::mat4 inverseRotationQuaternion = glm::rotate(glm::mat4(1.0f), glm::radians(rotationAngle), -worldAxis);
+		glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(3.0f / cubeSize));
+		glm::mat4 translation = glm::translate(glm::mat4(1.0f), position * cubieSpacing);
 
-		this->cubieTransformationMatrix = glm::rotate(transformationMatrix, glm::radians(rotationAngle), cubieAxis);
+		return scale * translation * orientationMatrices[orientations[cubie]];
+	}
+
+	// Used to rotate the moving cubies while a move is animated
+	// The rotation is applied on top of the resting matrix every frame instead of onto the previous frame, so it is thrown away once the move is done
+	void Animate(const glm::mat4& animationRotation)
+	{
+		for (size_t i = 0; i < movingCubies.size(); ++i)
+		{
+			models[movingCubies[i]] = animationRotation * GetRestingMatrix(movingCubies[i]);
+		}
+
+		modelsChanged = true;
+	}
+
+	// Moves the moving cubies by a number of counter clockwise quarter turns around a world axis
+	// Positions and orientations are integers, so they stay exact no matter how many moves are made
+	void RotateMovingCubies(int axis, int quarterTurns)
+	{
+		std::vector<uint8_t>& u = coordinates[(axis + 1) % 3];
+		std::vector<uint8_t>& v = coordinates[(axis + 2) % 3];
 
-		for (int i = 0; i < cubies.size(); ++i)
+		for (size_t i = 0; i < movingCubies.size(); ++i)
 		{
-			glm::mat4 transformationMatrix = rotationQuaternion * cubies[i]->cubieTransformationMatrix * inverseRotationQuaternion;
+			uint32_t cubie = movingCubies[i];
 
-			cubies[i]->Rotate(transformationMatrix, rotationAngle, worldAxis, worldAxis);
+			for (int turn = 0; turn < quarterTurns; ++turn)
+			{
+				uint8_t oldU = u[cubie];
+
+				u[cubie] = cubeSize - 1 - v[cubie];
+				v[cubie] = oldU;
+			}
 
-			glm::decompose(cubies[i]->cubieTransformationMatrix, scale, orientation, cubies[i]->cubiePosition, skew, perspective);
+			orientations[cubie] = rotationGroup.quarterTurns[orientations[cubie]][axis][quarterTurns];
 		}
 	}
+};
 
-	// Adds a cube to the construct
-	void AddCubie(std::vector<glm::vec3> colors, std::array<bool, 6> visible, glm::vec3 position)
+CubieStore cubieStore;
+
+// Main function, initializes OpenGL and the camera
+// The size of the cube can be passed as the first argument, 3 is used otherwise
+// Passing --benchmark and an optional number of cubes times the solver instead
+// Passing --optimal, an optional number of cubes and an optional scramble length times the optimal solver
+// Passing --moves, an optional number of cubes and an optional algorithm length times applying moves to many cubes at once
+// Passing --ranks and an optional number of cubes times turning cubes into ranks and back
+// In the RubiksCubeAllocations build, passing --allocations and an optional number of turns plays turns through the queue and the animation and counts the allocations
+// Passing --build-tables generates and checks the pruning tables up front, otherwise they are generated the first time a solver needs them
+// Builds the rubiks cube, binds the vertex data, loads textures and clears the resources when the program is closed
+// Contains a while loop as an update method
+int main(int argc, char* argv[])
+{
+	// Runs the solver benchmark without opening a window
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		RunSolverBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 1000);
+		return 0;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--moves")
 	{
-		cubies.push_back(new Cubie(colors, visible, position));
+		RunMoveBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 65536, argc > 3 ? std::max(1, atoi(argv[3])) : 1000);
+		return 0;
 	}
 
-	// Copies a cubie
-	void CopyCubie(Cubie& cubieToCopy)
+	if (argc > 1 && std::string(argv[1]) == "--ranks")
 	{
-		cubies.push_back(&cubieToCopy);
+		RunRankBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 1000000);
+		return 0;
 	}
 
-	// Deletes a cubie
-	void DeleteCubie(Cubie& cubieToRemove)
+#ifdef ALLOCATION_BENCHMARK
+	// Plays random turns of a 3x3x3 cube without opening a window, the whole cube is rotated every 1000 turns
+	// Fails when any turn allocated
+	if (argc > 1 && std::string(argv[1]) == "--allocations")
 	{
-		for (int i = 0; i < cubies.size(); ++i)
+		std::mt19937 random(1);
+		int turn = 0;
+
+		BuildRubiksCube();
+
+		int64_t allocations = RunAllocationBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 1000000, [&]()
 		{
-			if (cubies[i] == &cubieToRemove)
+			if (++turn % 1000 == 0)
+			{
+				RotateRubiksCube(YAWLEFT + random() % 4);
+			}
+			else
 			{
-				cubies.erase(cubies.begin() + i);
+				EnqueueTurnMove(TURNTOP + random() % 6, random() % 2 ? 1 : -1, random() % cubeSize);
+			}
+
+			// Long enough for every turn to finish in one frame
+			deltaTime = 1000.0f;
 
-				break;
+			while (!currentMove.Empty() || !moveQueue.Empty())
+			{
+				Update();
 			}
-		}
+		});
+
+		return allocations > 0 ? -1 : 0;
 	}
+#endif
 
-	// Returns the position of a cubie
-	void GetPosition(std::vector<glm::vec3> *positions)
+	// Generates every missing pruning table and checks the checksums of the ones that are already there
+	if (argc > 1 && std::string(argv[1]) == "--build-tables")
 	{
-		positions->push_back(this->cubiePosition);
-		for (int i = 0; i < cubies.size(); ++i)
+		verifyPruningTableChecksums = true;
+
+		int inconsistencies = GetTwoPhaseTables().CountPhase1Inconsistencies(200000);
+		GetPatternDatabases();
+
+		if (inconsistencies > 0)
 		{
-			cubies[i]->GetPosition(positions);
+			std::cout << "The phase 1 pruning table is inconsistent at " << inconsistencies << " of 200000 cubes" << std::endl;
+			return -1;
 		}
+
+		std::cout << "Pruning tables are ready" << std::endl;
+		return 0;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--optimal")
+	{
+		RunOptimalSolverBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 10, argc > 3 ? atoi(argv[3]) : 14);
+		return 0;
+	}
+
+	if (argc > 1)
+	{
+		cubeSize = std::max(minimumCubeSize, std::min(maximumCubeSize, atoi(argv[1])));
 	}
-};
 
-// Main function, initializes OpenGL and the camera
-// Builds the rubiks cube, binds the vertex data, loads textures and clears the resources when the program is closed
-// Contains a while loop as an update method
-int main()
-{
 	if (!InitialiseOpenGL())
 	{
 		return -1;
@@ -200,15 +336,25 @@ int main()
 
 	lightingShader = new Shader("Shaders/LightingShader.vert", "Shaders/LightingShader.frag");
 	skyboxShader = new Shader("Shaders/SkyboxShader.vert", "Shaders/SkyboxShader.frag");
+	lightingUniforms = GetLightingShaderUniforms(*lightingShader);
+	skyboxUniforms = GetSkyboxShaderUniforms(*skyboxShader);
 
 	glm::mat4 projection = glm::ortho(0.0f, static_cast<GLfloat>(screenWidth), 0.0f, static_cast<GLfloat>(screenHeight));
 
 	BuildRubiksCube();
 	BindVertexData();
+	BindUniformBuffers();
 	LoadTextures();
+	InitialiseLighting(lightingShader);
 
 	PrintInscructions();
 
+	// An algorithm after the size is played right away, like RubiksCube 3 "R U R' U'", and 54 facelets are loaded as they are
+	if (argc > 2)
+	{
+		EnqueueAlgorithmOrFacelets(argv[2]);
+	}
+
 	float oldTime = 0.0f;
 
 	while (!glfwWindowShouldClose(window))
@@ -263,38 +409,93 @@ bool InitialiseOpenGL()
 	//glEnable(GL_FRAMEBUFFER_SRGB);
 	//glEnable(GL_STENCIL_TEST);
 	//glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+	return true;
 }
 
-// Values for the lighting shader are set here
+// Values for the lighting shader are set here, once, they stay in the lights block and the program until it is deleted
 // Different materials can be simulated based on the values
 // Currently set to look like shiny plastic, like a real rubik's cube
-void InitialiseLighting(Shader* lightingShader, glm::mat4 projection, glm::mat4 view, glm::mat4 model)
+void InitialiseLighting(Shader* lightingShader)
 {
-	lightingShader->SetVector3("dirLight.direction", lightDirection);
-	lightingShader->SetVector3("dirLight.ambient", 0.3f, 0.3f, 0.3f);
-	lightingShader->SetVector3("dirLight.diffuse", 0.5f, 0.5f, 0.5f);
-	lightingShader->SetVector3("dirLight.specular", 0.6f, 0.6f, 0.6f);
+	LightsBlock lights;
+
+	lights.dirLight.direction = lightDirection;
+	lights.dirLight.ambient = glm::vec3(0.3f, 0.3f, 0.3f);
+	lights.dirLight.diffuse = glm::vec3(0.5f, 0.5f, 0.5f);
+	lights.dirLight.specular = glm::vec3(0.6f, 0.6f, 0.6f);
 
 	for (int i = 0; i < (sizeof(pointLightPosition) / sizeof(*pointLightPosition)); ++i)
 	{
-		lightingShader->SetVector3("pointLights[" + std::to_string(i) + "].position", pointLightPosition[i]);
-		lightingShader->SetVector3("pointLights[" + std::to_string(i) + "].ambient", 0.3f, 0.3f, 0.3f);
-		lightingShader->SetVector3("pointLights[" + std::to_string(i) + "].diffuse", 0.5f, 0.5f, 0.5f);
-		lightingShader->SetVector3("pointLights[" + std::to_string(i) + "].specular", 0.6f, 0.6f, 0.6f);
-
-		lightingShader->SetFloat("pointLights[" + std::to_string(i) + "].constant", 1.0f);
-		lightingShader->SetFloat("pointLights[" + std::to_string(i) + "].linear", 0.9f);
-		lightingShader->SetFloat("pointLights[" + std::to_string(i) + "].quadratic", 0.03f);
+		lights.pointLights[i].position = pointLightPosition[i];
+		lights.pointLights[i].ambient = glm::vec3(0.3f, 0.3f, 0.3f);
+		lights.pointLights[i].diffuse = glm::vec3(0.5f, 0.5f, 0.5f);
+		lights.pointLights[i].specular = glm::vec3(0.6f, 0.6f, 0.6f);
+
+		lights.pointLights[i].constant = 1.0f;
+		lights.pointLights[i].linear = 0.9f;
+		lights.pointLights[i].quadratic = 0.03f;
 	}
 
-	lightingShader->SetVector3("viewPos", camera.cameraPosition);
-	lightingShader->SetVector3("material.specular", 0.6f, 0.6f, 0.6f);
+	glBindBuffer(GL_UNIFORM_BUFFER, lightsUBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightsBlock), &lights);
 
-	lightingShader->SetFloat("material.shininess", 32.0f);
+	float diffuseMultiplier = 1.50f;
+	float ambientMultiplier = 1.0f * diffuseMultiplier;
 
-	lightingShader->SetMatrix4("projection", projection);
-	lightingShader->SetMatrix4("view", view);
-	lightingShader->SetMatrix4("model", model);
+	glm::vec3 ambientColours[7];
+	glm::vec3 diffuseColours[7];
+
+	for (int colour = 0; colour < 7; ++colour)
+	{
+		ambientColours[colour] = cubieColours[colour] * ambientMultiplier;
+		diffuseColours[colour] = cubieColours[colour] * diffuseMultiplier;
+	}
+
+	lightingShader->Use();
+	lightingShader->SetVector3(lightingUniforms.materialSpecular, glm::vec3(0.6f, 0.6f, 0.6f));
+	lightingShader->SetFloat(lightingUniforms.materialShininess, 32.0f);
+	lightingShader->SetVector3Array(lightingUniforms.ambientColours, ambientColours, 7);
+	lightingShader->SetVector3Array(lightingUniforms.diffuseColours, diffuseColours, 7);
+}
+
+// Creates the lights and camera blocks and connects both shaders to them
+void BindUniformBuffers()
+{
+	glGenBuffers(1, &lightsUBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, lightsUBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlock), nullptr, GL_STATIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, lightsBlockBinding, lightsUBO);
+
+	glGenBuffers(1, &cameraUBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, cameraBlockBinding, cameraUBO);
+
+	lightingShader->BindUniformBlock("Lights", lightsBlockBinding);
+	lightingShader->BindUniformBlock("Camera", cameraBlockBinding);
+	skyboxShader->BindUniformBlock("Camera", cameraBlockBinding);
+
+	// Zero never matches a real projection, so the first frame always uploads the camera
+	memset(&uploadedCamera, 0, sizeof(uploadedCamera));
+}
+
+// Writes the camera block if the camera changed since the last frame
+void UploadCameraBlock(const glm::mat4& projection, const glm::mat4& view)
+{
+	CameraBlock cameraBlock = uploadedCamera;
+
+	cameraBlock.projection = projection;
+	cameraBlock.view = view;
+	cameraBlock.viewPos = camera.cameraPosition;
+
+	if (memcmp(&cameraBlock, &uploadedCamera, sizeof(CameraBlock)) != 0)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &cameraBlock);
+
+		uploadedCamera = cameraBlock;
+	}
 }
 
 // Starts up the camera, by setting the view port, yaw and pitch
@@ -311,19 +512,48 @@ void BindVertexData()
 {
 	glGenVertexArrays(1, &rubiksCubeVAO);
 	glGenBuffers(1, &rubiksCubeVBO);
+	glGenBuffers(1, &rubiksCubeEBO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, rubiksCubeVBO);
-	glBufferData(GL_ARRAY_BUFFER, rubiksCubeVertexData.size() * sizeof(float), &rubiksCubeVertexData[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(cubieVertices), cubieVertices.data(), GL_STATIC_DRAW);
 
 	glBindVertexArray(rubiksCubeVAO);
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)0);
+	// The element buffer is part of the vertex array state
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rubiksCubeEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cubieIndices), cubieIndices.data(), GL_STATIC_DRAW);
+
+	// Positions and normals are converted from whole bytes to floats as they are, so -1, 0 and 1 stay exact
+	glVertexAttribPointer(0, 3, GL_BYTE, GL_FALSE, sizeof(CubieVertex), (void*)offsetof(CubieVertex, position));
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+	glVertexAttribPointer(1, 3, GL_BYTE, GL_FALSE, sizeof(CubieVertex), (void*)offsetof(CubieVertex, normal));
 	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CubieVertex), (void*)offsetof(CubieVertex, texCoords));
 	glEnableVertexAttribArray(2);
 
+	// Per cubie data is read straight from the arrays of the cubie store, once per instance
+	// A matrix takes up four attributes, one per column
+	glGenBuffers(1, &cubieModelVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, cubieModelVBO);
+
+	for (int column = 0; column < 4; ++column)
+	{
+		glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(3 + column);
+		glVertexAttribDivisor(3 + column, 1);
+	}
+
+	// The six side colours are split into the first four and the last two, an attribute holds at most four
+	glGenBuffers(1, &cubieColourVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, cubieColourVBO);
+
+	glVertexAttribIPointer(7, 4, GL_UNSIGNED_BYTE, sizeof(std::array<uint8_t, 6>), (void*)0);
+	glEnableVertexAttribArray(7);
+	glVertexAttribDivisor(7, 1);
+	glVertexAttribIPointer(8, 2, GL_UNSIGNED_BYTE, sizeof(std::array<uint8_t, 6>), (void*)(4 * sizeof(uint8_t)));
+	glEnableVertexAttribArray(8);
+	glVertexAttribDivisor(8, 1);
+
 	glGenVertexArrays(1, &skyboxVAO);
 	glGenBuffers(1, &skyboxVBO);
 	glBindVertexArray(skyboxVAO);
@@ -334,13 +564,15 @@ void BindVertexData()
 }
 
 // Loads the texutres from the given path
+// Every texture gets its own unit and is bound once here, drawing never binds a texture
 void LoadTextures()
 {
-	rubiksCubeTexture = LoadTexture("cubieTexture", { "Resources/Textures/RubiksCubeTile.png" });
-	blanktTileTexture = LoadTexture("cubieTexture", { "Resources/Textures/BlackTile.png" });
+	glActiveTexture(GL_TEXTURE0);
+	stickerTextures = LoadTextureArray({ "Resources/Textures/RubiksCubeTile.png", "Resources/Textures/BlackTile.png" });
 
 	lightingShader->Use();
-	lightingShader->SetInt("material.diffuseMap", 0);
+	lightingShader->SetInt(lightingUniforms.materialStickerTiles, 0);
+	SetStickerTheme(stickerTheme);
 
 	std::vector<std::string> skyboxFaces
 	{
@@ -352,51 +584,122 @@ void LoadTextures()
 		"Resources/Skybox/SkyboxLeft.png",
 	};
 
+	glActiveTexture(GL_TEXTURE1);
 	skyboxTextures = LoadTexture("skyboxTexture", skyboxFaces);
 
 	skyboxShader->Use();
-	skyboxShader->SetInt("skybox", 0);
+	skyboxShader->SetInt(skyboxUniforms.skybox, 1);
 }
 
+// Picks the layer of the sticker texture array every colour is drawn with
+void SetStickerTheme(int theme)
+{
+	stickerTheme = theme;
+
+	lightingShader->Use();
+	lightingShader->SetIntArray(lightingUniforms.sideLayers, stickerThemes[theme].layers, 7);
+}
 
-// The whole rubik's cube is built out of 27 individual cubies
-// The first one is a completely black cubie at the center, followed by 26 cubes arrayed around the center
-// Cubies on the outside of a side are added to the middle cubie of each side, this allows for easier turning of a side by iterating through and rotating all cubies attached to the middle one
-Cubie *rubiksCube = new Cubie({				{black}, {black}, {black}, {black}, {black}, {black} },		{ false, false, false, false, false, false },	glm::vec3(0.0f, 0.0f, 0.0f));
 
+// The whole rubik's cube is built out of N * N * N individual cubies, of which only the ones on the surface are stored
 void BuildRubiksCube()
 {
-	rubiksCube->AddCubie({					{white}, {black}, {black}, {black}, {black}, {black} },		{ true, false, false, false, false, false },	glm::vec3(0.0f, 2.1f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {black}, {blue}, {red}, {black}, {black} },		{ true, false, true, true, false, false },		glm::vec3(-2.1f, 2.1f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {black}, {black}, {red}, {black}, {black} },		{ true, false, false, true, false, false },		glm::vec3(-2.1f, 2.1f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {black}, {black}, {red}, {green}, {black} },		{ true, false, false, true, true, false },		glm::vec3(-2.1f, 2.1f, -2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {black}, {blue}, {black}, {black}, {black} },		{ true, false, true, false, false, false },		glm::vec3(0.0f, 2.1f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {black}, {black}, {black}, {green}, {black} },		{ true, false, false, false, true, false },		glm::vec3(0.0f, 2.1f, -2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {orange}, {blue}, {black}, {black}, {black} },		{ true, true, true, false, false, false },		glm::vec3(2.1f, 2.1f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {orange}, {black}, {black}, {black}, {black} },	{ true, true, false, false, false },			glm::vec3(2.1f, 2.1f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{white}, {orange}, {black}, {black}, {green}, {black} },	{ true, true, false, false, true, false },		glm::vec3(2.1f, 2.1f, -2.1f));
-
-	rubiksCube->AddCubie({					{black}, {orange}, {black}, {black}, {black}, {black} },	{ false, true, false, false, false, false },	glm::vec3(2.1f, 0.0f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {orange}, {blue}, {black}, {black}, {black} },		{ false, true, true, false, false, false },		glm::vec3(2.1f, 0.0f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {orange}, {black}, {black}, {green}, {black} },	{ false, true, false, false, true, false },		glm::vec3(2.1f, 0.0f, -2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {orange}, {blue}, {black}, {black}, {yellow} },	{ false, true, true, false, false, true },		glm::vec3(2.1f, -2.1f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {orange}, {black}, {black}, {black}, {yellow} },	{ false, true, false, false, false, true },		glm::vec3(2.1f, -2.1f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {orange}, {black}, {black}, {green}, {yellow} },	{ false, true, false, false, true, true },		glm::vec3(2.1f, -2.1f, -2.1f));
-
-	rubiksCube->AddCubie({					{black}, {black}, {blue}, {black}, {black}, {black} },		{ false, false, true, false, false, false },	glm::vec3(0.0f, 0.0f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {blue}, {red}, {black}, {black} },		{ false, false, true, true, false, false },		glm::vec3(-2.1f, 0.0f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {blue}, {red}, {black}, {yellow} },		{ false, false, true, true, false, true },		glm::vec3(-2.1f, -2.1f, 2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {blue}, {black}, {black}, {yellow} },		{ false, false, true, false, false, true },		glm::vec3(0.0f, -2.1f, 2.1f));
-
-	rubiksCube->AddCubie({					{black}, {black}, {black}, {red}, {black}, {black} },		{ false, false, false, true, false, false },	glm::vec3(-2.1f, 0.0f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {black}, {red}, {green}, {black} },		{ false, false, false, true, true, false },		glm::vec3(-2.1f, 0.0f, -2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {black}, {red}, {black}, {yellow} },		{ false, false, false, true, false, true },		glm::vec3(-2.1f, -2.1f, 0.0f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {black}, {red}, {green}, {yellow} },		{ false, false, false, true, true, true },		glm::vec3(-2.1f, -2.1f, -2.1f));
-		
-	rubiksCube->AddCubie({					{black}, {black}, {black}, {black}, {green}, {black} },		{ false, false, false, false, true, false },	glm::vec3(0.0f, 0.0f, -2.1f));
-	rubiksCube->cubies.back()->AddCubie({	{black}, {black}, {black}, {black}, {green}, {yellow} },	{ false, false, false, false, true, true },		glm::vec3(0.0f, -2.1f, -2.1f));
-
-	rubiksCube->AddCubie({					{black}, {black}, {black}, {black}, {black}, {yellow} },	{ false, false, false, false, false, true },	glm::vec3(0.0f, -2.1f, 0.0f));
+	puzzleState = PuzzleState(cubeSize);
+
+	BuildCubies();
+}
+
+// Builds the cubies in their resting orientation, a side of a cubie gets the colour of the facelet of the puzzle state it shows
+// Sides inside the cube stay black
+void BuildCubies()
+{
+	cubieStore.Clear();
+
+	for (int x = 0; x < cubeSize; ++x)
+	{
+		for (int y = 0; y < cubeSize; ++y)
+		{
+			for (int z = 0; z < cubeSize; ++z)
+			{
+				glm::ivec3 position = glm::ivec3(x, y, z);
+
+				// Position measured in half cubies from the centre of the cube, outer layers sit at N - 1
+				glm::ivec3 centredPosition = position * 2 - (cubeSize - 1);
+
+				std::array<uint8_t, 6> colours;
+				bool surface = false;
+
+				for (int face = 0; face < 6; ++face)
+				{
+					glm::ivec3 facing = centredPosition * faceNormals[face];
+					colours[face] = blankColour;
+
+					if (facing.x + facing.y + facing.z == cubeSize - 1)
+					{
+						int cubeFace = GetCubeFace(faceNormals[face]);
+						int column = (DotProduct(centredPosition, cubeFaceColumns[cubeFace]) + cubeSize - 1) / 2;
+						int row = (DotProduct(centredPosition, cubeFaceRows[cubeFace]) + cubeSize - 1) / 2;
+
+						colours[face] = GetFaceColour(puzzleState.GetFacelet(cubeFace, row, column));
+						surface = true;
+					}
+				}
+
+				if (surface)
+				{
+					cubieStore.AddCubie(position, colours);
+				}
+			}
+		}
+	}
+}
+
+// Replaces the cube with the state of 54 facelets, the cube becomes a 3x3x3 cube held the default way
+// Only possible once every queued turn is done, returns false and prints why if the state is not loaded
+bool LoadFaceletString(const char* facelets)
+{
+	CubeState state;
+	int error = ParseFaceletString(facelets, state);
+
+	if (error != FACELETSVALID)
+	{
+		std::cout << "Could not load the cube, " << faceletErrorMessages[error] << std::endl;
+		return false;
+	}
+
+	if (!currentMove.Empty() || !moveQueue.Empty())
+	{
+		std::cout << "Could not load the cube while it is turning" << std::endl;
+		return false;
+	}
+
+	cubeSize = 3;
+	cubeState = state;
+	cubeOrientation = 0;
+	SetPuzzleStateFacelets(cubeState, puzzleState);
+
+	BuildCubies();
+
+	return true;
+}
+
+// Plays an algorithm, or loads a cube state if the text holds 54 facelets instead
+bool EnqueueAlgorithmOrFacelets(const char* text)
+{
+	CubeState state;
+
+	if (ParseFaceletString(text, state) != FACELETLENGTH)
+	{
+		return LoadFaceletString(text);
+	}
+
+	if (!EnqueueAlgorithm(text))
+	{
+		std::cout << "Could not read the algorithm " << text << std::endl;
+		return false;
+	}
+
+	return true;
 }
 
 // General function to draw in the window
@@ -407,41 +710,68 @@ void Draw()
 
 	glm::mat4 projection = glm::perspective(glm::radians(camera.cameraZoom), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
 	glm::mat4 view = camera.GetViewMatrix();
-	glm::mat4 model = glm::mat4(1.0f);
 
-	DrawCube(lightingShader, projection, view, model);
-	DrawSkybox(projection, view, model);
+	UploadCameraBlock(projection, view);
+
+	DrawCube(lightingShader);
+	DrawSkybox();
 
 	glfwSwapBuffers(window);
 	glfwPollEvents();
 }
 
 // Draws the cube so it can be displayed in the window
-void DrawCube(Shader* lightingShader, glm::mat4 projection, glm::mat4 view, glm::mat4 model)
+void DrawCube(Shader* lightingShader)
 {
 	lightingShader->Use();
 
-	InitialiseLighting(lightingShader, projection, view, model);
-
 	glBindVertexArray(rubiksCubeVAO);
-	rubiksCube->DrawCubie(lightingShader);
+	DrawCubies();
+}
+
+// Draws every cubie and applies the lighting shader
+// All cubies are drawn as instances of one cube in a single draw call, the shader picks the colour of every side from the instance data
+void DrawCubies()
+{
+	UploadCubieInstances();
+
+	glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)cubieIndices.size(), GL_UNSIGNED_SHORT, (void*)0, cubieStore.Size());
+}
+
+// Copies the cubie store into the instance buffers, the colours only when the cubies were built again and the matrices only when a move changed them
+void UploadCubieInstances()
+{
+	if (cubieStore.coloursChanged)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, cubieColourVBO);
+		glBufferData(GL_ARRAY_BUFFER, cubieStore.Size() * sizeof(std::array<uint8_t, 6>), cubieStore.colours.data(), GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ARRAY_BUFFER, cubieModelVBO);
+		glBufferData(GL_ARRAY_BUFFER, cubieStore.Size() * sizeof(glm::mat4), cubieStore.models.data(), GL_DYNAMIC_DRAW);
+
+		cubieStore.coloursChanged = false;
+		cubieStore.modelsChanged = false;
+	}
 
+	if (cubieStore.modelsChanged)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, cubieModelVBO);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, cubieStore.Size() * sizeof(glm::mat4), cubieStore.models.data());
+
+		cubieStore.modelsChanged = false;
+	}
 }
 
 // Draws the skybox so it can be displayed in the window
-void DrawSkybox(glm::mat4 projection, glm::mat4 view, glm::mat4 model)
+// The shader takes the view and projection from the camera block and drops the translation of the view itself
+void DrawSkybox()
 {
 	glDepthMask(GL_FALSE);
 
 	skyboxShader->Use();
-	
-	view = glm::mat4(glm::mat3(camera.GetViewMatrix()));
-	skyboxShader->SetMatrix4("view", view);
-	skyboxShader->SetMatrix4("projection", projection);
 
 	glDepthFunc(GL_LEQUAL);
 	glBindVertexArray(skyboxVAO);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTextures);
 	glDrawArrays(GL_TRIANGLES, 0, 36);
 	glDepthMask(GL_TRUE);
 }
@@ -454,7 +784,19 @@ void ProcessKeyboard(GLFWwindow* window)
 		glfwSetWindowShouldClose(window, true);
 	}
 
-	if (currentMove.empty() || moveQueue.empty())
+	if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS)
+	{
+		tKeyPressed = true;
+	}
+	else if (glfwGetKey(window, GLFW_KEY_T) == GLFW_RELEASE && tKeyPressed)
+	{
+		SetStickerTheme((stickerTheme + 1) % stickerThemeCount);
+		std::cout << "Sticker theme: " << stickerThemes[stickerTheme].name << std::endl;
+
+		tKeyPressed = false;
+	}
+
+	if (currentMove.Empty() || moveQueue.Empty())
 	{
 		if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
 		{
@@ -464,7 +806,7 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (freeCam)
 			{
-				SoundEngine->play2D("Resources/Sounds/SwitchSound.mp3");
+				PlaySoundEffect("Resources/Sounds/SwitchSound.mp3");
 				//std::cout << camera.Position.x << ", " << camera.Position.y << ", " << camera.Position.z << ", " << camera.Yaw << ", " << camera.Pitch << std::endl;
 				std::cout << "FreeCam deactivated" << std::endl;
 				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -475,7 +817,7 @@ void ProcessKeyboard(GLFWwindow* window)
 			}
 			else
 			{
-				SoundEngine->play2D("Resources/Sounds/SwitchSound.mp3");
+				PlaySoundEffect("Resources/Sounds/SwitchSound.mp3");
 				std::cout << "FreeCam activated" << std::endl;
 				glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 				freeCam = true;
@@ -486,7 +828,7 @@ void ProcessKeyboard(GLFWwindow* window)
 
 	if (!freeCam)
 	{
-		if (!currentMove.empty() || !moveQueue.empty())
+		if (!currentMove.Empty() || !moveQueue.Empty())
 		{
 		}
 		else
@@ -536,6 +878,15 @@ void ProcessKeyboard(GLFWwindow* window)
 			}
 		}
 
+		// Number keys pick the layer of the next turn, counted from the turned face
+		for (int layer = 0; layer < 9 && layer < cubeSize; ++layer)
+		{
+			if (glfwGetKey(window, GLFW_KEY_1 + layer) == GLFW_PRESS)
+			{
+				selectedLayer = layer;
+			}
+		}
+
 		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 		{
 			wKeyPressed = true;
@@ -544,11 +895,11 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNTOP, -1);
+				EnqueueSelectedTurnMove(TURNTOP, -1);
 			}
 			else
 			{
-				EnqueueTurnMove(TURNTOP, 1);
+				EnqueueSelectedTurnMove(TURNTOP, 1);
 			}
 
 			wKeyPressed = false;
@@ -562,11 +913,11 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNLEFT, -1);
+				EnqueueSelectedTurnMove(TURNLEFT, -1);
 			}
 			else
 			{
-				EnqueueTurnMove(TURNLEFT, 1);
+				EnqueueSelectedTurnMove(TURNLEFT, 1);
 			}
 
 			aKeyPressed = false;
@@ -580,11 +931,11 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNBOTTOM, -1);
+				EnqueueSelectedTurnMove(TURNBOTTOM, -1);
 			}
 			else
 			{
-				EnqueueTurnMove(TURNBOTTOM, 1);
+				EnqueueSelectedTurnMove(TURNBOTTOM, 1);
 			}
 
 			sKeyPressed = false;
@@ -598,11 +949,11 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNRIGHT, -1);
+				EnqueueSelectedTurnMove(TURNRIGHT, -1);
 			}
 			else
 			{
-				EnqueueTurnMove(TURNRIGHT, 1);
+				EnqueueSelectedTurnMove(TURNRIGHT, 1);
 			}
 
 			dKeyPressed = false;
@@ -616,11 +967,11 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNFRONT, -1);
+				EnqueueSelectedTurnMove(TURNFRONT, -1);
 			}
 			else
 			{
-				EnqueueTurnMove(TURNFRONT, 1);
+				EnqueueSelectedTurnMove(TURNFRONT, 1);
 			}
 
 			qKeyPressed = false;
@@ -634,17 +985,75 @@ void ProcessKeyboard(GLFWwindow* window)
 		{
 			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
 			{
-				EnqueueTurnMove(TURNBACK, -1);
+				EnqueueSelectedTurnMove(TURNBACK, -1);
 			}
 			else
 			{
 
-				EnqueueTurnMove(TURNBACK, 1);
+				EnqueueSelectedTurnMove(TURNBACK, 1);
 
 			}
 
 			eKeyPressed = false;
 		}
+
+		// Control + V plays the algorithm on the clipboard, or loads the cube state if the clipboard holds 54 facelets
+		if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS && glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+		{
+			vKeyPressed = true;
+		}
+		else if (glfwGetKey(window, GLFW_KEY_V) == GLFW_RELEASE && vKeyPressed)
+		{
+			const char* clipboard = glfwGetClipboardString(window);
+
+			if (clipboard == nullptr)
+			{
+				std::cout << "The clipboard does not hold an algorithm" << std::endl;
+			}
+			else
+			{
+				EnqueueAlgorithmOrFacelets(clipboard);
+			}
+
+			vKeyPressed = false;
+		}
+
+		// Control + C copies the facelets of the 3x3x3 cube, measured against its centres
+		if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+		{
+			cKeyPressed = true;
+		}
+		else if (glfwGetKey(window, GLFW_KEY_C) == GLFW_RELEASE && cKeyPressed)
+		{
+			if (cubeSize == 3)
+			{
+				char facelets[faceletCount + 1];
+				FormatFaceletString(cubeState, facelets);
+
+				glfwSetClipboardString(window, facelets);
+				std::cout << "Cube: " << facelets << std::endl;
+			}
+
+			cKeyPressed = false;
+		}
+
+		if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS)
+		{
+			enterKeyPressed = true;
+		}
+		else if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_RELEASE && enterKeyPressed)
+		{
+			if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+			{
+				SolveRubiksCubeOptimally();
+			}
+			else
+			{
+				SolveRubiksCube();
+			}
+
+			enterKeyPressed = false;
+		}
 	}
 
 	else if (freeCam)
@@ -669,114 +1078,33 @@ void ProcessKeyboard(GLFWwindow* window)
 }
 
 // Executed when the whole cube is being rotated
-// Checks what the new top and front sides will be after the move and swaps the axis acoordingly to keep track of the cube orientation
+// The orientation of the cube is one element of the rotation group, so the new one is a single lookup once the turn is known
 // Adds the move to the move queue so it can be animated in the update method
 void RotateRubiksCube(int moveType)
 {
-	int newFrontFace = 0;
-	int newTopFace = 0;
-
-	if (faceLookupTable[frontFace][moveType][topFace][0] == 'W')
-		newFrontFace = YELLOWFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][0] == 'O')
-		newFrontFace = REDFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][0] == 'B')
-		newFrontFace = GREENFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][0] == 'R')
-		newFrontFace = ORANGEFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][0] == 'G')
-		newFrontFace = BLUEFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][0] == 'Y')
-		newFrontFace = WHITEFACE;
-
-	if (faceLookupTable[frontFace][moveType][topFace][1] == 'W')
-		newTopFace = YELLOWFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][1] == 'O')
-		newTopFace = REDFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][1] == 'B')
-		newTopFace = GREENFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][1] == 'R')
-		newTopFace = ORANGEFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][1] == 'G')
-		newTopFace = BLUEFACE;
-	else if (faceLookupTable[frontFace][moveType][topFace][1] == 'Y')
-		newTopFace = WHITEFACE;
-
-	frontFace = newFrontFace;
-	topFace = newTopFace;
-
-	switch (frontFace)
-	{
-	case WHITEFACE:
-	case YELLOWFACE:
-		switch (topFace)
-		{
-		case REDFACE:
-		case ORANGEFACE:
-			rubiksCubeXAxis = ZAXIS;
-			rubiksCubeYAxis = XAXIS;
-			break;
-		case BLUEFACE:
-		case GREENFACE:
-			rubiksCubeXAxis = XAXIS;
-			rubiksCubeYAxis = ZAXIS;
-			break;
-		}
-		rubiksCubeZAxis = YAXIS;
-		break;
-	case BLUEFACE:
-	case GREENFACE:
-		switch (topFace)
-		{
-		case ORANGEFACE:
-		case REDFACE:
-			rubiksCubeXAxis = YAXIS;
-			rubiksCubeYAxis = XAXIS;
-			break;
-		case YELLOWFACE:
-		case WHITEFACE:
-			rubiksCubeXAxis = XAXIS;
-			rubiksCubeYAxis = YAXIS;
-			break;
-		}
-		rubiksCubeZAxis = ZAXIS;
-		break;
-	case ORANGEFACE:
-	case REDFACE:
-		switch (topFace)
-		{
-		case BLUEFACE:
-		case GREENFACE:
-			rubiksCubeXAxis = YAXIS;
-			rubiksCubeYAxis = ZAXIS;
-			break;
-		case WHITEFACE:
-		case YELLOWFACE:
-			rubiksCubeXAxis = ZAXIS;
-			rubiksCubeYAxis = YAXIS;
-			break;
-		}
-		rubiksCubeZAxis = XAXIS;
-		break;
-	}
-
-	SoundEngine->play2D("Resources/Sounds/SwooshSound.mp3");
+	PlaySoundEffect("Resources/Sounds/SwooshSound.mp3");
 
 	switch (moveType) 
 	{
 	case PITCHUP:
-		currentMove.push_back(new TurnMove(0, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), -90.0f, false));
+		currentMove.Start(TurnMove(0, glm::vec3(1.0f, 0.0f, 0.0f), -90.0f, false));
 		break;
 	case PITCHDOWN:
-		currentMove.push_back(new TurnMove(0, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 90.0f, false));
+		currentMove.Start(TurnMove(0, glm::vec3(1.0f, 0.0f, 0.0f), 90.0f, false));
 		break;
 	case YAWLEFT:
-		currentMove.push_back(new TurnMove(0, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, false));
+		currentMove.Start(TurnMove(0, glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, false));
 		break;
 	case YAWRIGHT:
-		currentMove.push_back(new TurnMove(0, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 90.0f, false));
+		currentMove.Start(TurnMove(0, glm::vec3(0.0f, 1.0f, 0.0f), 90.0f, false));
 		break;
 	}
+
+	SelectAllCubies();
+	UpdateSlots(currentMove.Get());
+
+	int axis = currentMove.Get().worldAxis.x != 0.0f ? XAXIS : YAXIS;
+	cubeOrientation = rotationGroup.quarterTurns[cubeOrientation][axis][currentMove.Get().rotationAngle > 0.0f ? 1 : 3];
 }
 
 // Update method is being used to animate the cube
@@ -784,279 +1112,313 @@ void RotateRubiksCube(int moveType)
 // Positions are moved by a few degrees every frame to achieve a smooth animation
 void Update()
 {
-	if (currentMove.empty() && !moveQueue.empty())
-	{
-		PerformTurnMove(moveQueue.back()[0], moveQueue.back()[1], moveQueue.back()[2]);
+	EnqueueOptimalSolution();
+
+	MoveCode move;
 
-		moveQueue.pop_back();
+	if (currentMove.Empty() && moveQueue.Pop(move))
+	{
+		PerformTurnMove(move);
 	}
 
-	if (!currentMove.empty())
+	if (!currentMove.Empty())
 	{
-		animationAngle += (currentMove[0]->rotationAngle / 200) * deltaTime; 
+		animationAngle += (currentMove.Get().rotationAngle / 200) * deltaTime; 
 
-		if (currentMove[0]->cubie)
-		{
-			rubiksCube->cubies[currentMove[0]->faceIndex]->Rotate(rubiksCube->cubies[currentMove[0]->faceIndex]->cubieTransformationMatrix, animationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-			rubiksCube->cubies[currentMove[0]->faceIndex]->Rotate(rubiksCube->cubies[currentMove[0]->faceIndex]->cubieTransformationMatrix, -currentMove[0]->currentRotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-		}
-		else
+		if (std::abs(animationAngle) >= std::abs(currentMove.Get().rotationAngle))
 		{
-			rubiksCube->Rotate(rubiksCube->cubieTransformationMatrix, animationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-			rubiksCube->Rotate(rubiksCube->cubieTransformationMatrix, -currentMove[0]->currentRotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-		}
+			cubieStore.Animate(glm::mat4(1.0f));
 
-		currentMove[0]->currentRotationAngle = animationAngle;
+			animationAngle = 0.0f;
 
-		if (sqrtf(animationAngle * animationAngle) >= sqrtf(currentMove[0]->rotationAngle * currentMove[0]->rotationAngle))
+			currentMove.Finish();
+		}
+		else
 		{
-			if (currentMove[0]->cubie)
-			{
-				rubiksCube->cubies[currentMove[0]->faceIndex]->Rotate(rubiksCube->cubies[currentMove[0]->faceIndex]->cubieTransformationMatrix, currentMove[0]->rotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-				rubiksCube->cubies[currentMove[0]->faceIndex]->Rotate(rubiksCube->cubies[currentMove[0]->faceIndex]->cubieTransformationMatrix, -currentMove[0]->currentRotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-			}
-			else
-			{
-				rubiksCube->Rotate(rubiksCube->cubieTransformationMatrix, currentMove[0]->rotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-				rubiksCube->Rotate(rubiksCube->cubieTransformationMatrix, -currentMove[0]->currentRotationAngle, currentMove[0]->cubieAxis, currentMove[0]->worldAxis);
-			}
-			
-			animationAngle = 0.0f;
+			// The slots already hold the end of the move, so the cubies are turned back by the part of the move that is still missing
+			glm::quat animationRotation = glm::angleAxis(glm::radians(animationAngle - currentMove.Get().rotationAngle), currentMove.Get().worldAxis);
 
-			currentMove.pop_back();
+			cubieStore.Animate(glm::mat4_cast(animationRotation));
 		}
 	}
 }
 
 // Adds turn moves to the queue
 // Put in a separate method so turn moves can be buffered, unlike moves that rotate the whole cube that need to be executed first to keep positions up to date
-void EnqueueTurnMove(int moveType, int moveDirection)
+// The cube state is updated right away, the animation catches up once the move leaves the queue
+// layerDepth counts layers from the turned face, 0 being the face itself, and layerWidth is the number of layers turned together
+void EnqueueTurnMove(int moveType, int moveDirection, int layerDepth, int layerWidth)
 {
-	int faceIndex = 0;
+	layerDepth = std::min(layerDepth, cubeSize - 1);
+	layerWidth = std::max(1, std::min(layerWidth, cubeSize - layerDepth));
 
-	for (int i = 0; i < rubiksCube->cubies.size(); ++i)
+	if (!moveQueue.Push(MakeMoveCode(GetCubeFace(turnMoveNormals[moveType - TURNTOP]), moveDirection == 1 ? 1 : 3, layerDepth, layerWidth), cubeSize))
 	{
-		switch (moveType)
-		{
-		case TURNTOP:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.y, 2.1f))
-			{
-				faceIndex = i;
-			}
-			break;
-		case TURNRIGHT:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.x, 2.1f)) 
-			{ 
-				faceIndex = i; 
-			}
-			break;
-		case TURNFRONT:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.z, 2.1f))
-			{
-				faceIndex = i;
-			}
-			break;
-		case TURNLEFT:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.x, -2.1f))
-			{
-				faceIndex = i;
-			}
-			break;
-		case TURNBACK:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.z, -2.1f))
-			{
-				faceIndex = i;
-			}
-			break;
-		case TURNBOTTOM:
-			if (ComparePositions(rubiksCube->cubies[i]->cubiePosition.y, -2.1f))
-			{
-				faceIndex = i;
-			}
-			break;
-		}
+		std::cout << "Too many turns are waiting, the turn was left out" << std::endl;
+		return;
 	}
-	moveQueue.insert(moveQueue.begin(), { faceIndex, moveDirection, moveType });
+
+	// The rotation of the whole cube is undone to find the face in the frame of the cube
+	int cubeFace = rotationGroup.worldToCubeFaces[cubeOrientation][GetCubeFace(turnMoveNormals[moveType - TURNTOP])];
+
+	// Same path the headless tools take, it keeps the 3x3x3 cube state in step as well
+	ApplyMoveCode(cubeState, puzzleState, MakeMoveCode(cubeFace, moveDirection == 1 ? 1 : 3, layerDepth, layerWidth));
 }
 
-// This determines what cubies are currently at the side that needs to be rotate and copies the 8 cubies on the middle cubie of that side
-// The copies that were copied are then deleted from the middle cubie they were attached to before
-void AttachRingCubies(int faceIndex, std::vector<glm::vec3> positions, std::vector<int> cubePositions)
+// Turns the layer picked with the number keys, or every layer up to it while control is held
+// Goes back to the outer layer afterwards
+void EnqueueSelectedTurnMove(int moveType, int moveDirection)
 {
-	if (cubePositions.size() > 0)
+	if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
 	{
-		for (int i = 0; i < 8; ++i)
-		{
-			for (int j = 0; j < rubiksCube->cubies.size(); ++j)
-			{
-				if (j != faceIndex)
-				{
-					for (int k = 0; k < rubiksCube->cubies[j]->cubies.size(); ++k)
-					{
-						if (ComparePositions(positions[cubePositions[i]].x, rubiksCube->cubies[j]->cubies[k]->cubiePosition.x) && ComparePositions(positions[cubePositions[i]].y, rubiksCube->cubies[j]->cubies[k]->cubiePosition.y) && ComparePositions(positions[cubePositions[i]].z, rubiksCube->cubies[j]->cubies[k]->cubiePosition.z))
-						{
-							rubiksCube->cubies[faceIndex]->CopyCubie(*rubiksCube->cubies[j]->cubies[k]);
+		EnqueueTurnMove(moveType, moveDirection, 0, selectedLayer + 1);
+	}
+	else
+	{
+		EnqueueTurnMove(moveType, moveDirection, selectedLayer, 1);
+	}
 
-							rubiksCube->cubies[j]->DeleteCubie(*rubiksCube->cubies[j]->cubies[k]);
-						}
-					}
-				}
-			}
-		}
+	selectedLayer = 0;
+}
+
+// Adds a move in standard notation to the queue
+// Faces are seen from the viewer, and rotations are played as turns of every layer so the view itself never changes
+void EnqueueMoveCode(MoveCode move)
+{
+	int moveType = GetTurnMoveType(GetMoveFace(move));
+	int layerDepth;
+	int layerWidth;
+	GetMoveLayers(move, cubeSize, layerDepth, layerWidth);
+
+	if (layerWidth < 1)
+	{
+		return;
+	}
+
+	switch (GetMoveQuarterTurns(move))
+	{
+	case 1:
+		EnqueueTurnMove(moveType, 1, layerDepth, layerWidth);
+		break;
+	case 2:
+		EnqueueTurnMove(moveType, 1, layerDepth, layerWidth);
+		EnqueueTurnMove(moveType, 1, layerDepth, layerWidth);
+		break;
+	case 3:
+		EnqueueTurnMove(moveType, -1, layerDepth, layerWidth);
+		break;
 	}
 }
 
-// Called when a key to rotate a side is pressed
-// Calls the AttachRingCubies function and adds the respective move to the queue
-void PerformTurnMove(int faceIndex, int moveDirection, int moveType) 
+// Reads an algorithm like "R U R' U'" and adds every move to the queue, returns false if it could not be read
+// The moves are read into one buffer that is kept between calls, as large as the queue itself
+bool EnqueueAlgorithm(const char* algorithm)
 {
-	std::vector<glm::vec3> positions = {};
+	static std::array<MoveCode, moveQueueCapacity> moves;
+	int moveCount = ParseMoveCodes(algorithm, moves.data(), (int)moves.size());
 
-	std::vector<int> cubiesToAttach = {};
+	for (int i = 0; i < moveCount; ++i)
+	{
+		EnqueueMoveCode(moves[i]);
+	}
+
+	return moveCount >= 0;
+}
 
-	glm::vec3 axis;
+// Solves the cube and adds the solution to the queue, so it is played back like any other turns
+// Only the 3x3x3 cube can be solved, and only once every queued turn is done
+void SolveRubiksCube()
+{
+	if (cubeSize != 3 || !currentMove.Empty() || !moveQueue.Empty())
+	{
+		return;
+	}
 
-	rubiksCube->GetPosition(&positions);
+	// The tables are built the first time the cube is solved
+	static TwoPhaseSolver solver;
 
-	SoundEngine->play2D("Resources/Sounds/TurnSound.mp3");
+	bool solved = false;
+	std::vector<int> solution = solver.Solve(cubeState, 20, defaultTwoPhaseNodeLimit, &solved);
 
-	switch(moveType)
+	if (!solved)
 	{
-		case TURNTOP:
-			axis = GetAxis(rubiksCubeYAxis, faceIndex);
+		std::cout << "No solution was found within the node limit" << std::endl;
+		return;
+	}
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].y, rubiksCube->cubies[faceIndex]->cubiePosition.y))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+	PrintSolution(solution);
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+	for (size_t i = 0; i < solution.size(); ++i)
+	{
+		EnqueueCubeMove(solution[i]);
+	}
+}
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 1.0f, 0.0f), -90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 1.0f, 0.0f), 90.0f));
-			}
-			break;
-		case TURNBOTTOM:
-			axis = GetAxis(rubiksCubeYAxis, faceIndex);
+// Starts searching for a solution with the fewest possible turns on another thread
+// The pattern databases are built the first time, which takes a while
+void SolveRubiksCubeOptimally()
+{
+	if (cubeSize != 3 || optimalSolution.valid() || !currentMove.Empty() || !moveQueue.Empty())
+	{
+		return;
+	}
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].y, rubiksCube->cubies[faceIndex]->cubiePosition.y))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+	std::cout << "Searching for an optimal solution..." << std::endl;
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+	optimalSolutionState = cubeState;
+	optimalSolution = std::async(std::launch::async, [](CubeState state)
+	{
+		return OptimalSolver().Solve(state, &cancelOptimalSolution);
+	}, cubeState);
+}
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 1.0f, 0.0f), 90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 1.0f, 0.0f), -90.0f));
-			}
-			break;
-		case TURNLEFT:
-			axis = GetAxis(rubiksCubeXAxis, faceIndex);
+// Queues the optimal solution once the search is done
+void EnqueueOptimalSolution()
+{
+	if (!optimalSolution.valid() || optimalSolution.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return;
+	}
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].x, rubiksCube->cubies[faceIndex]->cubiePosition.x))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+	std::vector<int> solution = optimalSolution.get();
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+	std::cout << "Optimal solution found, " << solution.size() << " moves" << std::endl;
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(1.0f, 0.0f, 0.0f), 90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(1.0f, 0.0f, 0.0f), -90.0f));
-			}
-			break;
-		case TURNRIGHT:
-			axis = GetAxis(rubiksCubeXAxis, faceIndex);
+	if (cubeState != optimalSolutionState)
+	{
+		return;
+	}
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].x, rubiksCube->cubies[faceIndex]->cubiePosition.x))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+	PrintSolution(solution);
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+	for (size_t i = 0; i < solution.size(); ++i)
+	{
+		EnqueueCubeMove(solution[i]);
+	}
+}
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(1.0f, 0.0f, 0.0f), -90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(1.0f, 0.0f, 0.0f), 90.0f));
-			}
-			break;
-		case TURNFRONT:
-			axis = GetAxis(rubiksCubeZAxis, faceIndex);
+// Prints a solution the way the cube is held on screen, in standard notation
+void PrintSolution(const std::vector<int>& solution)
+{
+	std::array<MoveCode, 64> moves;
+	std::array<char, 512> text;
+	int moveCount = std::min((int)solution.size(), (int)moves.size());
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].z, rubiksCube->cubies[faceIndex]->cubiePosition.z))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+	for (int i = 0; i < moveCount; ++i)
+	{
+		// The centre move is a turn of the cube, the inverse orientation turns it back into a turn on screen
+		MoveCode move = GetCentreMoveCode(puzzleState, solution[i]);
+		int cubeMove = GetMoveFace(move) * 3 + GetMoveQuarterTurns(move) - 1;
+		int worldMove = rotationGroup.conjugateMoves[rotationGroup.inverses[cubeOrientation]][cubeMove];
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+		moves[i] = GetCubeMoveCode(worldMove);
+	}
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 0.0f, 1.0f), -90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 0.0f, 1.0f), 90.0f));
-			}
-			break;
-		case TURNBACK:
-			axis = GetAxis(rubiksCubeZAxis, faceIndex);
+	if (FormatMoveCodes(moves.data(), moveCount, text.data(), (int)text.size()) >= 0)
+	{
+		std::cout << "Solution: " << text.data() << std::endl;
+	}
+}
 
-			for (int i = 0; i < positions.size(); ++i)
-			{
-				if (positions[i] != rubiksCube->cubies[faceIndex]->cubiePosition && ComparePositions(positions[i].z, rubiksCube->cubies[faceIndex]->cubiePosition.z))
-				{
-					cubiesToAttach.push_back(i);
-				}
-			}
+// Adds a move of the cube state to the queue, half turns are added as two quarter turns
+// The cube state is measured against the centres, so the move is turned into a turn of whatever face shows that centre on screen
+void EnqueueCubeMove(int move)
+{
+	int centre = move / 3;
+	int cubeFace = UFACE;
 
-			AttachRingCubies(faceIndex, positions, cubiesToAttach);
+	// Slice turns move the centres, so the face holding the centre is looked up
+	for (int face = 0; face < 6; ++face)
+	{
+		if (puzzleState.GetFacelet(face, 1, 1) == centre)
+		{
+			cubeFace = face;
+		}
+	}
 
-			if (moveDirection == 1)
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 0.0f, 1.0f), 90.0f));
-			}
-			else
-			{
-				currentMove.push_back(new TurnMove(faceIndex, axis, glm::vec3(0.0f, 0.0f, 1.0f), -90.0f));
-			}
-			break;
+	int moveType = GetTurnMoveType(rotationGroup.cubeToWorldFaces[cubeOrientation][cubeFace]);
+
+	switch (move % 3)
+	{
+	case 0:
+		EnqueueTurnMove(moveType, 1);
+		break;
+	case 1:
+		EnqueueTurnMove(moveType, 1);
+		EnqueueTurnMove(moveType, 1);
+		break;
+	case 2:
+		EnqueueTurnMove(moveType, -1);
+		break;
 	}
 }
 
+// This looks up what cubies are currently in the layers that need to be rotated
+// A layer is a single coordinate along the axis of the turned face, so this is one pass over one array of the cubie store
+void SelectLayerCubies(int moveType, int layerDepth, int layerWidth)
+{
+	glm::ivec3 normal = turnMoveNormals[moveType - TURNTOP];
+	int axis = normal.x != 0 ? XAXIS : (normal.y != 0 ? YAXIS : ZAXIS);
+
+	int firstLayer = normal[axis] > 0 ? cubeSize - layerDepth - layerWidth : layerDepth;
+	int lastLayer = firstLayer + layerWidth - 1;
+
+	const std::vector<uint8_t>& layerCoordinates = cubieStore.coordinates[axis];
+
+	cubieStore.movingCubies.clear();
+
+	for (int cubie = 0; cubie < cubieStore.Size(); ++cubie)
+	{
+		if (layerCoordinates[cubie] >= firstLayer && layerCoordinates[cubie] <= lastLayer)
+		{
+			cubieStore.movingCubies.push_back(cubie);
+		}
+	}
+}
+
+// Selects every cubie, used when the whole cube is rotated
+void SelectAllCubies()
+{
+	cubieStore.movingCubies.clear();
+
+	for (int cubie = 0; cubie < cubieStore.Size(); ++cubie)
+	{
+		cubieStore.movingCubies.push_back(cubie);
+	}
+}
+
+// Moves the slots of every cubie that takes part in a move to where they will end up
+void UpdateSlots(const TurnMove& turnMove)
+{
+	int axis = turnMove.worldAxis.x != 0.0f ? XAXIS : (turnMove.worldAxis.y != 0.0f ? YAXIS : ZAXIS);
+	int quarterTurns = ((int)std::round(turnMove.rotationAngle / 90.0f) % 4 + 4) % 4;
+
+	cubieStore.RotateMovingCubies(axis, quarterTurns);
+}
+
+// Called when a key to rotate a side is pressed
+// Calls the SelectLayerCubies function and adds the respective move to the queue
+void PerformTurnMove(MoveCode move)
+{
+	int faceIndex = GetMoveFace(move);
+	int moveType = GetTurnMoveType(faceIndex);
+	int layerDepth = GetMoveDepth(move);
+	int layerWidth = GetMoveWidth(move);
+
+	PlaySoundEffect("Resources/Sounds/TurnSound.mp3");
+
+	SelectLayerCubies(moveType, layerDepth, layerWidth);
+
+	// A clockwise turn seen from the U, R or F face turns the opposite way around its axis to one seen from the D, L or B face
+	const int8_t* normal = rotationFaceNormals[faceIndex];
+	int turns = GetMoveQuarterTurns(move) == 3 ? -1 : GetMoveQuarterTurns(move);
+	glm::vec3 worldAxis = glm::abs(glm::vec3(normal[0], normal[1], normal[2]));
+
+	currentMove.Start(TurnMove(faceIndex, worldAxis, -90.0f * turns * (normal[0] + normal[1] + normal[2])));
+
+	UpdateSlots(currentMove.Get());
+}
+
 // Method to keep track of the mouse cursor
 void CursorPosCallback(GLFWwindow *window, double x, double y)
 {
@@ -1082,20 +1444,29 @@ void CursorPosCallback(GLFWwindow *window, double x, double y)
 // Clears the resources to prevent memory leaks
 void ClearResources()
 {
-	for (int i = 0; i < currentMove.size(); ++i)
-	{
-		delete currentMove[i];
-	}
+	// Stops a running optimal search, so closing the window does not wait for it
+	cancelOptimalSolution = true;
 
 	delete lightingShader;
 	delete skyboxShader;
 
-	SoundEngine->drop();
+	if (SoundEngine != nullptr)
+	{
+		SoundEngine->drop();
+	}
 	
 	glDeleteVertexArrays(1, &rubiksCubeVAO);
 	glDeleteVertexArrays(1, &skyboxVAO);
 
 	glDeleteBuffers(1, &rubiksCubeVBO);
+	glDeleteBuffers(1, &rubiksCubeEBO);
+	glDeleteBuffers(1, &cubieModelVBO);
+	glDeleteBuffers(1, &cubieColourVBO);
+	glDeleteBuffers(1, &lightsUBO);
+	glDeleteBuffers(1, &cameraUBO);
+
+	glDeleteTextures(1, &stickerTextures);
+	glDeleteTextures(1, &skyboxTextures);
 	glDeleteBuffers(1, &skyboxVBO);
 	
 	glfwDestroyWindow(window);
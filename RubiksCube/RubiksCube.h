@@ -1,42 +1,66 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include <stb_image.h>
 
+#include "Notation.h"
+#include "RotationGroup.h"
+
 enum Axes { XAXIS, YAXIS, ZAXIS };
 enum Faces { WHITEFACE, ORANGEFACE, BLUEFACE, REDFACE, GREENFACE, YELLOWFACE };
 enum Moves { YAWLEFT, YAWRIGHT, PITCHUP, PITCHDOWN, TURNTOP, TURNRIGHT, TURNFRONT, TURNLEFT, TURNBACK, TURNBOTTOM, TURNMOVE, ROTATEMOVE, NONE};
 
-int main();
+struct TurnMove;
+
+int main(int argc, char* argv[]);
 bool InitialiseOpenGL();
-void InitialiseLighting(Shader* lightingShader, glm::mat4 projection, glm::mat4 view, glm::mat4 model);
+void InitialiseLighting(Shader* lightingShader);
+void BindUniformBuffers();
+void UploadCameraBlock(const glm::mat4& projection, const glm::mat4& view);
 void InitialiseCamera();
 
 void LoadTextures();
+void SetStickerTheme(int theme);
 void BindVertexData();
 void BuildRubiksCube();
+void BuildCubies();
 
 void Draw();
-void DrawSkybox(glm::mat4 projection, glm::mat4 view, glm::mat4 model);
-void DrawCube(Shader* lightingShader, glm::mat4 projection, glm::mat4 view, glm::mat4 model);
+void DrawSkybox();
+void DrawCube(Shader* lightingShader);
+void DrawCubies();
+void UploadCubieInstances();
 
 void ProcessKeyboard(GLFWwindow *window);
 
 void Update();
 
 void RotateRubiksCube(int moveType);
-void EnqueueTurnMove(int moveType, int moveDirection);
-void AttachRingCubies(int faceIndex, std::vector<glm::vec3> positions, std::vector<int> cubePositions);
-void PerformTurnMove(int faceIndex, int moveDirection, int moveType);
+void EnqueueTurnMove(int moveType, int moveDirection, int layerDepth = 0, int layerWidth = 1);
+void EnqueueSelectedTurnMove(int moveType, int moveDirection);
+void EnqueueMoveCode(MoveCode move);
+bool EnqueueAlgorithm(const char* algorithm);
+bool EnqueueAlgorithmOrFacelets(const char* text);
+bool LoadFaceletString(const char* facelets);
+void SolveRubiksCube();
+void SolveRubiksCubeOptimally();
+void EnqueueOptimalSolution();
+void PrintSolution(const std::vector<int>& solution);
+void EnqueueCubeMove(int move);
+void SelectLayerCubies(int moveType, int layerDepth, int layerWidth);
+void SelectAllCubies();
+void UpdateSlots(const TurnMove& turnMove);
+void PerformTurnMove(MoveCode move);
 
 void CursorPosCallback(GLFWwindow *window, double x, double y);
 
 void ClearResources();
 
-glm::vec3 GetAxis(int axis, int faceIndex);
-
 // Colours for the cube textures
 glm::vec3 black = glm::vec3(0.0f, 0.0f, 0.0f);
 glm::vec3 white = glm::vec3(1.0f, 1.0f, 1.0f);
@@ -46,6 +70,26 @@ glm::vec3 red = glm::vec3(1.0f, 0.0f, 0.0f);
 glm::vec3 green = glm::vec3(0.0f, 1.0f, 0.0f);
 glm::vec3 yellow = glm::vec3(1.0f, 1.0f, 0.0f);
 
+// Colours of the cubie sides indexed by Faces, the sides inside the cube use the last one
+static const uint8_t blankColour = 6;
+static const glm::vec3 cubieColours[7] = { white, orange, blue, red, green, yellow, black };
+
+// Outward normal of every face, indexed by Faces
+static const glm::ivec3 faceNormals[6] = { glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, -1), glm::ivec3(0, -1, 0) };
+
+// Returns the colour, indexed by Faces, of the face in CubeFaces order
+static uint8_t GetFaceColour(int cubeFace)
+{
+	uint8_t colour = 0;
+
+	while (faceNormals[colour] != cubeFaceNormals[cubeFace])
+	{
+		++colour;
+	}
+
+	return colour;
+}
+
 // Determines which direction the light of the lighting shader comes from
 // Currently comes from the big star on the skybox
 static glm::vec3 lightDirection = glm::vec3(9.0f, 13.0f, 7.0f);
@@ -61,50 +105,62 @@ static glm::vec3 pointLightPosition[] =
 	glm::vec3(0.0f, 0.0f, -5.0f),
 };
 
-// Geometrical data cube 
-static std::vector<float>rubiksCubeVertexData = 
+// Geometrical data of a cubie, one cube with 4 vertices per side, the sides in the order of Faces
+// Positions and normals are whole numbers, so they are stored as bytes, and the texture coordinates as half floats
+// A vertex takes 12 bytes instead of 8 floats, and the 24 vertices are shared by the 36 corners of the triangles through the indices
+struct CubieVertex
 {
-	-1.0,  1.0, -1.0,  0.0,  1.0,  0.0,  0.0,  1.0,
-	 1.0,  1.0,  1.0,  0.0,  1.0,  0.0,  1.0,  0.0,
-	 1.0,  1.0, -1.0,  0.0,  1.0,  0.0,  1.0,  1.0,
-	 1.0,  1.0,  1.0,  0.0,  1.0,  0.0,  1.0,  0.0,
-	-1.0,  1.0, -1.0,  0.0,  1.0,  0.0,  0.0,  1.0,
-	-1.0,  1.0,  1.0,  0.0,  1.0,  0.0,  0.0,  0.0,
-
-	 1.0,  1.0,  1.0,  1.0,  0.0,  0.0,  1.0,  0.0,
-	 1.0, -1.0, -1.0,  1.0,  0.0,  0.0,  0.0,  1.0,
-	 1.0,  1.0, -1.0,  1.0,  0.0,  0.0,  1.0,  1.0,
-	 1.0, -1.0, -1.0,  1.0,  0.0,  0.0,  0.0,  1.0,
-	 1.0,  1.0,  1.0,  1.0,  0.0,  0.0,  1.0,  0.0,
-	 1.0, -1.0,  1.0,  1.0,  0.0,  0.0,  0.0,  0.0,
-
-	-1.0, -1.0,  1.0,  0.0,  0.0,  1.0,  0.0,  0.0,
-	 1.0, -1.0,  1.0,  0.0,  0.0,  1.0,  1.0,  0.0,
-	 1.0,  1.0,  1.0,  0.0,  0.0,  1.0,  1.0,  1.0,
-	 1.0,  1.0,  1.0,  0.0,  0.0,  1.0,  1.0,  1.0,
-	-1.0,  1.0,  1.0,  0.0,  0.0,  1.0,  0.0,  1.0,
-	-1.0, -1.0,  1.0,  0.0,  0.0,  1.0,  0.0,  0.0,
-
-	-1.0,  1.0,  1.0, -1.0,  0.0,  0.0,  1.0,  0.0,
-	-1.0,  1.0, -1.0, -1.0,  0.0,  0.0,  1.0,  1.0,
-	-1.0, -1.0, -1.0, -1.0,  0.0,  0.0,  0.0,  1.0,
-	-1.0, -1.0, -1.0, -1.0,  0.0,  0.0,  0.0,  1.0,
-	-1.0, -1.0,  1.0, -1.0,  0.0,  0.0,  0.0,  0.0,
-	-1.0,  1.0,  1.0, -1.0,  0.0,  0.0,  1.0,  0.0,
-
-	-1.0, -1.0, -1.0,  0.0,  0.0, -1.0,  0.0,  0.0,
-	 1.0,  1.0, -1.0,  0.0,  0.0, -1.0,  1.0,  1.0,
-	 1.0, -1.0, -1.0,  0.0,  0.0, -1.0,  1.0,  0.0,
-	 1.0,  1.0, -1.0,  0.0,  0.0, -1.0,  1.0,  1.0,
-	-1.0, -1.0, -1.0,  0.0,  0.0, -1.0,  0.0,  0.0,
-	-1.0,  1.0, -1.0,  0.0,  0.0, -1.0,  0.0,  1.0,
-
-	-1.0, -1.0, -1.0,  0.0, -1.0,  0.0,  0.0,  1.0,
-	 1.0, -1.0, -1.0,  0.0, -1.0,  0.0,  1.0,  1.0,
-	 1.0, -1.0,  1.0,  0.0, -1.0,  0.0,  1.0,  0.0,
-	 1.0, -1.0,  1.0,  0.0, -1.0,  0.0,  1.0,  0.0,
-	-1.0, -1.0,  1.0,  0.0, -1.0,  0.0,  0.0,  0.0,
-	-1.0, -1.0, -1.0,  0.0, -1.0,  0.0,  0.0,  1.0
+	int8_t position[4];
+	int8_t normal[4];
+	uint16_t texCoords[2];
+};
+
+// Bit patterns of 0 and 1 as IEEE half floats
+static const uint16_t halfFloatZero = 0x0000;
+static const uint16_t halfFloatOne = 0x3C00;
+
+static const std::array<CubieVertex, 24> cubieVertices =
+{ {
+	{ { -1,  1, -1 }, {  0,  1,  0 }, { halfFloatZero, halfFloatOne } },
+	{ {  1,  1,  1 }, {  0,  1,  0 }, { halfFloatOne, halfFloatZero } },
+	{ {  1,  1, -1 }, {  0,  1,  0 }, { halfFloatOne, halfFloatOne } },
+	{ { -1,  1,  1 }, {  0,  1,  0 }, { halfFloatZero, halfFloatZero } },
+
+	{ {  1,  1,  1 }, {  1,  0,  0 }, { halfFloatOne, halfFloatZero } },
+	{ {  1, -1, -1 }, {  1,  0,  0 }, { halfFloatZero, halfFloatOne } },
+	{ {  1,  1, -1 }, {  1,  0,  0 }, { halfFloatOne, halfFloatOne } },
+	{ {  1, -1,  1 }, {  1,  0,  0 }, { halfFloatZero, halfFloatZero } },
+
+	{ { -1, -1,  1 }, {  0,  0,  1 }, { halfFloatZero, halfFloatZero } },
+	{ {  1, -1,  1 }, {  0,  0,  1 }, { halfFloatOne, halfFloatZero } },
+	{ {  1,  1,  1 }, {  0,  0,  1 }, { halfFloatOne, halfFloatOne } },
+	{ { -1,  1,  1 }, {  0,  0,  1 }, { halfFloatZero, halfFloatOne } },
+
+	{ { -1,  1,  1 }, { -1,  0,  0 }, { halfFloatOne, halfFloatZero } },
+	{ { -1,  1, -1 }, { -1,  0,  0 }, { halfFloatOne, halfFloatOne } },
+	{ { -1, -1, -1 }, { -1,  0,  0 }, { halfFloatZero, halfFloatOne } },
+	{ { -1, -1,  1 }, { -1,  0,  0 }, { halfFloatZero, halfFloatZero } },
+
+	{ { -1, -1, -1 }, {  0,  0, -1 }, { halfFloatZero, halfFloatZero } },
+	{ {  1,  1, -1 }, {  0,  0, -1 }, { halfFloatOne, halfFloatOne } },
+	{ {  1, -1, -1 }, {  0,  0, -1 }, { halfFloatOne, halfFloatZero } },
+	{ { -1,  1, -1 }, {  0,  0, -1 }, { halfFloatZero, halfFloatOne } },
+
+	{ { -1, -1, -1 }, {  0, -1,  0 }, { halfFloatZero, halfFloatOne } },
+	{ {  1, -1, -1 }, {  0, -1,  0 }, { halfFloatOne, halfFloatOne } },
+	{ {  1, -1,  1 }, {  0, -1,  0 }, { halfFloatOne, halfFloatZero } },
+	{ { -1, -1,  1 }, {  0, -1,  0 }, { halfFloatZero, halfFloatZero } }
+} };
+
+// Two triangles per side, the vertex shader finds the side of a vertex from its index
+static const std::array<GLushort, 36> cubieIndices =
+{
+	 0,  1,  2,  1,  0,  3,
+	 4,  5,  6,  5,  4,  7,
+	 8,  9, 10, 10, 11,  8,
+	12, 13, 14, 14, 15, 12,
+	16, 17, 18, 17, 16, 19,
+	20, 21, 22, 22, 23, 20
 };
 
 // Geometrical data of the skybox
@@ -154,79 +210,155 @@ static std::vector<float>skyboxVertexData =
 	 1.0f, -1.0f,  1.0f
 };
 
-// Lookup table to check which sides need to switch when the cube is being rotated 
-static std::vector<std::vector<std::vector<std::string>>> faceLookupTable =
-{
-	{
-		{"00", "GO", "OB", "BR", "BO", "00"},
-		{"00", "BO", "RB", "GR", "OG", "00"},
-		{"00", "OY", "BY", "RY", "GY", "00"},
-		{"00", "RW", "GW", "OW", "BW", "00"}
-	},
-
-	{
-		{"BW", "00", "YB", "00", "WG", "GY"},
-		{"GW", "00", "WB", "00", "YG", "BY"},
-		{"WR", "00", "BR", "00", "GR", "YR"},
-		{"YO", "00", "GO", "00", "BO", "WO"}
-	},
-
-	{
-		{"RW", "WO", "00", "YR", "00", "OY"},
-		{"OW", "YO", "00", "WR", "00", "RY"},
-		{"WG", "OG", "00", "RG", "00", "YG"},
-		{"YB", "RB", "00", "OB", "00", "WB"}
-	},
-
-	{
-		{"GW", "00", "WB", "00", "YG", "BY"},
-		{"BW", "00", "YB", "00", "WG", "GY"},
-		{"WO", "00", "BO", "00", "GO", "YR"},
-		{"YR", "00", "GR", "00", "BR", "WR"}
-	},
-
-	{
-		{"OW", "YO", "00", "WR", "00", "RY"},
-		{"RW", "WO", "00", "YR", "00", "OY"},
-		{"WB", "OB", "00", "RB", "00", "YB"},
-		{"YG", "RG", "00", "OG", "00", "WG"}
-	},
-
-	{
-		{"00", "BO", "RB", "GR", "OG", "00"},
-		{"00", "GO", "OB", "BR", "RG", "00"},
-		{"00", "OW", "BW", "RW", "GW", "00"},
-		{"00", "RY", "GY", "OY", "BY", "00"}
-	},
-};
-
 // Struct to define a move when turn a side of the cube
+// Slots and orientations jump to the end of the move straight away, the animation only rotates the matrices from where the move started
 struct TurnMove
 {
 	int faceIndex = 0;
 
-	glm::vec3 cubieAxis = glm::vec3(0.0f);
 	glm::vec3 worldAxis = glm::vec3(0.0f);
 
 	float rotationAngle = 0.0f;
-	float currentRotationAngle = 0.0f;
 	
 	bool cubie = true;
+
+	TurnMove()
+	{
+	}
 	
-	TurnMove(int face, glm::vec3 cubieAxis, glm::vec3 worldAxis, float rotationAngle, bool cubie = true)
+	TurnMove(int face, glm::vec3 worldAxis, float rotationAngle, bool cubie = true)
 	{
 		this->faceIndex = face;
 
-		this->cubieAxis = cubieAxis;
 		this->worldAxis = worldAxis;
 				
 		this->rotationAngle = rotationAngle;
-		this->currentRotationAngle = 0.0f;
 
 		this->cubie = cubie;
 	}
 };
 
+// The turn that is being animated, held by value in one slot that is reused
+// Starting and finishing a turn never allocates, so animating any number of moves keeps memory flat
+// Only one turn is animated at a time, a turn is only started while the slot is empty
+struct AnimationSlot
+{
+	TurnMove turnMove;
+	bool active = false;
+
+	bool Empty() const
+	{
+		return !active;
+	}
+
+	// Returns the slot the turn was started in
+	TurnMove& Start(const TurnMove& turnMove)
+	{
+		this->turnMove = turnMove;
+		active = true;
+
+		return this->turnMove;
+	}
+
+	const TurnMove& Get() const
+	{
+		return turnMove;
+	}
+
+	// Frees the slot once the turn is done
+	void Finish()
+	{
+		active = false;
+	}
+};
+
+// Uniform blocks shared by the shaders, laid out like the std140 blocks in the shaders
+// Every vec3 takes up 16 bytes in std140, the floats next to them fill the gaps
+static const GLuint lightsBlockBinding = 0;
+static const GLuint cameraBlockBinding = 1;
+
+struct DirLightBlock
+{
+	glm::vec3 direction;
+	float directionPadding;
+	glm::vec3 ambient;
+	float ambientPadding;
+	glm::vec3 diffuse;
+	float diffusePadding;
+	glm::vec3 specular;
+	float specularPadding;
+};
+
+struct PointLightBlock
+{
+	glm::vec3 position;
+	float constant;
+	glm::vec3 ambient;
+	float linear;
+	glm::vec3 diffuse;
+	float quadratic;
+	glm::vec3 specular;
+	float specularPadding;
+};
+
+// Written once, the lights never move
+struct LightsBlock
+{
+	DirLightBlock dirLight;
+	PointLightBlock pointLights[6];
+};
+
+// Written at most once per frame, only when the camera moved or zoomed
+struct CameraBlock
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::vec3 viewPos;
+	float viewPosPadding;
+};
+
+static_assert(sizeof(LightsBlock) == 448, "LightsBlock has to match the std140 layout of the Lights block");
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock has to match the std140 layout of the Camera block");
+
+// Locations of the uniforms that are not in a block, looked up once after the shaders are built so setting them never searches a name
+struct LightingShaderUniforms
+{
+	GLint materialSpecular;
+	GLint materialShininess;
+	GLint materialStickerTiles;
+	GLint ambientColours;
+	GLint diffuseColours;
+	GLint sideLayers;
+};
+
+struct SkyboxShaderUniforms
+{
+	GLint skybox;
+};
+
+static LightingShaderUniforms GetLightingShaderUniforms(const Shader& shader)
+{
+	LightingShaderUniforms uniforms;
+
+	uniforms.materialSpecular = shader.GetUniformLocation("material.specular");
+	uniforms.materialShininess = shader.GetUniformLocation("material.shininess");
+	uniforms.materialStickerTiles = shader.GetUniformLocation("material.stickerTiles");
+	uniforms.ambientColours = shader.GetUniformLocation("ambientColours");
+	uniforms.diffuseColours = shader.GetUniformLocation("diffuseColours");
+	uniforms.sideLayers = shader.GetUniformLocation("sideLayers");
+
+	return uniforms;
+}
+
+static SkyboxShaderUniforms GetSkyboxShaderUniforms(const Shader& shader)
+{
+	SkyboxShaderUniforms uniforms;
+
+	uniforms.skybox = shader.GetUniformLocation("skybox");
+
+	return uniforms;
+}
+
 // Method to load the texture from the image files in the solution folder
 static GLuint LoadTexture(std::string textureType, std::vector<std::string> filePath)
 {
@@ -243,18 +375,7 @@ static GLuint LoadTexture(std::string textureType, std::vector<std::string> file
 
 		if (data)
 		{
-			if (textureType == "cubieTexture")
-			{
-				glBindTexture(GL_TEXTURE_2D, texture);
-
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-				glGenerateMipmap(GL_TEXTURE_2D);
-
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_RGBA);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_RGBA);
-			}
-			else if(textureType == "skyboxTexture")
+			if(textureType == "skyboxTexture")
 			{
 				glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
 
@@ -276,38 +397,130 @@ static GLuint LoadTexture(std::string textureType, std::vector<std::string> file
 	return texture;
 }
 
-// Compares two positions and checks them against an accuracy value, due to vertices sometimes moving from 2.1 to 2.099999
-bool ComparePositions(float a, float b)
+// Loads tiles of the same size into the layers of one texture array, every image is read as RGBA whatever channels it has
+// A plain white tile is added as the last layer, so a side can take its colour everywhere instead of only inside the sticker
+// An image that fails to load or has another size than the first one is replaced by the plain tile, so every image keeps the layer of its place in the list
+static GLuint LoadTextureArray(std::vector<std::string> filePath)
 {
-	return std::abs(a - b) <= 0.1f;
+	std::vector<unsigned char*> layers;
+	int width = 0;
+	int height = 0;
+
+	for (int i = 0; i < (int)filePath.size(); i++)
+	{
+		int layerWidth;
+		int layerHeight;
+		int nrChannels;
+		unsigned char* data = stbi_load(filePath[i].c_str(), &layerWidth, &layerHeight, &nrChannels, 4);
+
+		if (data && width == 0)
+		{
+			width = layerWidth;
+			height = layerHeight;
+		}
+
+		if (!data || layerWidth != width || layerHeight != height)
+		{
+			std::cout << "Failed to load texture " << filePath[i] << std::endl;
+			stbi_image_free(data);
+			data = nullptr;
+		}
+
+		layers.push_back(data);
+	}
+
+	// Without any image the tiles are a single white texel
+	width = std::max(width, 1);
+	height = std::max(height, 1);
+
+	std::vector<unsigned char> plainTile(width * height * 4, 255);
+	layers.push_back(nullptr);
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, (GLsizei)layers.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	for (int layer = 0; layer < (int)layers.size(); layer++)
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layers[layer] ? layers[layer] : plainTile.data());
+
+		stbi_image_free(layers[layer]);
+	}
+
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+	return texture;
 }
 
-// Returns the axis that the cube has to be rotated around
-glm::vec3 GetAxis(int axisID, int faceIndex)
+// Layers of the sticker texture array
+enum StickerLayers { STICKERLAYER, BLANKLAYER, PLAINLAYER };
+
+// Which layer every cubie colour is drawn with, indexed like cubieColours, the sides inside the cube use the last one
+// Switching themes only sets one uniform array, the texture array stays bound
+struct StickerTheme
+{
+	const char* name;
+	GLint layers[7];
+};
+
+static const StickerTheme stickerThemes[] =
 {
-	glm::vec3 axis = glm::vec3(0, 0, 0);
+	{ "Stickers", { STICKERLAYER, STICKERLAYER, STICKERLAYER, STICKERLAYER, STICKERLAYER, STICKERLAYER, BLANKLAYER } },
+	{ "Stickerless", { PLAINLAYER, PLAINLAYER, PLAINLAYER, PLAINLAYER, PLAINLAYER, PLAINLAYER, BLANKLAYER } },
+};
+
+static const int stickerThemeCount = sizeof(stickerThemes) / sizeof(*stickerThemes);
+
+// Distance between the centres of two neighbouring cubies
+static const float cubieSpacing = 2.1f;
 
-	switch (axisID)
+// Smallest and largest cube that can be built, the size is given as the first command line argument
+static const int minimumCubeSize = 2;
+static const int maximumCubeSize = 64;
+
+// Outward normals of the faces that TURNTOP, TURNRIGHT, TURNFRONT, TURNLEFT, TURNBACK and TURNBOTTOM turn, in world space
+static const glm::ivec3 turnMoveNormals[6] = { glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, -1), glm::ivec3(0, -1, 0) };
+
+// Returns the turn move of the face in CubeFaces order that points along the same world normal
+static int GetTurnMoveType(int face)
+{
+	int moveType = TURNTOP;
+
+	while (turnMoveNormals[moveType - TURNTOP] != cubeFaceNormals[face])
 	{
-	case XAXIS:
-		axis = glm::vec3(1.0f, 0.0f, 0.0f);
-		break;
-	case YAXIS:
-		axis = glm::vec3(0.0f, 1.0f, 0.0f);
-		break;
-	case ZAXIS:
-		axis = glm::vec3(0.0f, 0.0f, 1.0f);
-		break;
+		++moveType;
 	}
 
-	if (faceIndex != WHITEFACE && faceIndex != ORANGEFACE && faceIndex != BLUEFACE)
+	return moveType;
+}
+
+// Turns that can wait in the queue at once, enough for a pasted algorithm of many thousand moves
+static const uint32_t moveQueueCapacity = 1 << 16;
+
+// Converts the 24 exact cubie orientations to matrices OpenGL can use
+static std::array<glm::mat4, 24> BuildOrientationMatrices()
+{
+	std::array<glm::mat4, 24> matrices;
+
+	for (int i = 0; i < 24; ++i)
 	{
-		axis *= -1;
+		matrices[i] = glm::mat4(1.0f);
+
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 3; ++column)
+			{
+				matrices[i][column][row] = rotationGroup.rotations[i].matrix[row][column];
+			}
+		}
 	}
 
-	return axis;
+	return matrices;
 }
 
+static const std::array<glm::mat4, 24> orientationMatrices = BuildOrientationMatrices();
+
 // Self-explanatory, I hope
 void PrintInscructions()
 {
@@ -321,5 +534,12 @@ void PrintInscructions()
 	std::cout << "D Key:		Turn Right" << std::endl;
 	std::cout << "Q Key:		Turn Front" << std::endl;
 	std::cout << "E Key:		Turn Back \n" << std::endl;
-	std::cout << "F Key:		Free Cam \n" << std::endl;
+	std::cout << "1-9 Keys:	Turn an Inner Layer with the next Turn" << std::endl;
+	std::cout << "Control Key:	Hold to Turn all Layers up to the selected one \n" << std::endl;
+	std::cout << "Control + V:	Play the Algorithm or load the 54 Facelets on the Clipboard" << std::endl;
+	std::cout << "Control + C:	Copy the 54 Facelets of the Cube" << std::endl;
+	std::cout << "Enter Key:	Solve the Cube" << std::endl;
+	std::cout << "Shift + Enter:	Solve the Cube in the fewest Turns \n" << std::endl;
+	std::cout << "F Key:		Free Cam" << std::endl;
+	std::cout << "T Key:		Switch the Sticker Theme \n" << std::endl;
 }
@@ -1,6 +1,10 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 class Shader
 {
@@ -13,64 +17,140 @@ public:
 		glUseProgram(ID); 
 	}
 
-	void SetBool(const std::string& name, bool value) const 
+	// Location of an active uniform, or -1 if the program does not use it, which every glUniform call ignores
+	// A hash lookup in the table read at link time, the driver is never asked and the name is never copied
+	// Uniforms that are set more than once can keep the location and use the setters that take one
+	GLint GetUniformLocation(const char* name) const
+	{
+		if (uniformLocations.empty())
+		{
+			return -1;
+		}
+
+		size_t mask = uniformLocations.size() - 1;
+
+		// Linear probing, the table is never full so an empty slot ends the search
+		for (size_t slot = HashUniformName(name) & mask; !uniformLocations[slot].name.empty(); slot = (slot + 1) & mask)
+		{
+			if (uniformLocations[slot].name == name)
+			{
+				return uniformLocations[slot].location;
+			}
+		}
+
+		return -1;
+	}
+
+	void SetBool(const char* name, bool value) const 
 	{ 
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+		glUniform1i(GetUniformLocation(name), (int)value); 
+	}
+
+	void SetInt(const char* name, int value)	const 
+	{
+		SetInt(GetUniformLocation(name), value);
 	}
 
-	void SetInt(const std::string& name, int value)	const 
+	void SetIntArray(const char* name, const GLint* values, int count) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+		SetIntArray(GetUniformLocation(name), values, count);
 	}
 
-	void SetFloat(const std::string& name, float value)	const 
+	void SetFloat(const char* name, float value)	const 
 	{ 
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+		SetFloat(GetUniformLocation(name), value);
 	}
 
-	void SetVector2(const std::string& name, const glm::vec2& value) const 
+	void SetVector2(const char* name, const glm::vec2& value) const 
 	{ 
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform2fv(GetUniformLocation(name), 1, &value[0]);
 	}
 
-	void SetVector2(const std::string& name, float x, float y) const 
+	void SetVector2(const char* name, float x, float y) const 
 	{ 
-		glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+		glUniform2f(GetUniformLocation(name), x, y);
 	}
 	
-	void SetVector3(const std::string& name, const glm::vec3& value) const
+	void SetVector3(const char* name, const glm::vec3& value) const
 	{ 
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-	
+		SetVector3(GetUniformLocation(name), value);
 	}
-	void SetVector3(const std::string& name, float x, float y, float z)	const 
+
+	void SetVector3(const char* name, float x, float y, float z)	const 
 	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+		glUniform3f(GetUniformLocation(name), x, y, z);
+	}
+
+	void SetVector3Array(const char* name, const glm::vec3* values, int count) const
+	{
+		SetVector3Array(GetUniformLocation(name), values, count);
 	}
 	
-	void SetVector4(const std::string& name, const glm::vec4& value) const 
+	void SetVector4(const char* name, const glm::vec4& value) const 
 	{ 
-		glUniform4fv(	glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform4fv(GetUniformLocation(name), 1, &value[0]);
 	}
 
-	void SetVector4(const std::string& name, float x, float y, float z, float w) const 
+	void SetVector4(const char* name, float x, float y, float z, float w) const 
 	{ 
-		glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+		glUniform4f(GetUniformLocation(name), x, y, z, w);
 	}
 
-	void SetMatrix2(const std::string& name, const glm::mat2& mat)	const 
+	void SetMatrix2(const char* name, const glm::mat2& mat)	const 
 	{ 
-		glUniformMatrix2fv(	glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix2fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 	}
 
-	void SetMatrix3(const std::string& name, const glm::mat3& mat)	const 
+	void SetMatrix3(const char* name, const glm::mat3& mat)	const 
 	{ 
-		glUniformMatrix3fv( glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 	}
 
-	void SetMatrix4(const std::string& name, const glm::mat4& mat)	const 
+	void SetMatrix4(const char* name, const glm::mat4& mat)	const 
 	{ 
-		glUniformMatrix4fv( glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		SetMatrix4(GetUniformLocation(name), mat);
+	}
+
+	// Connects a uniform block of the program to a binding point, blocks the program does not use are skipped
+	void BindUniformBlock(const char* name, GLuint binding) const
+	{
+		GLuint blockIndex = glGetUniformBlockIndex(ID, name);
+
+		if (blockIndex != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(ID, blockIndex, binding);
+		}
+	}
+
+	// Setters for a location that was looked up once, so setting the uniform again skips the name lookup
+	void SetInt(GLint location, int value) const
+	{
+		glUniform1i(location, value);
+	}
+
+	void SetIntArray(GLint location, const GLint* values, int count) const
+	{
+		glUniform1iv(location, count, values);
+	}
+
+	void SetFloat(GLint location, float value) const
+	{
+		glUniform1f(location, value);
+	}
+
+	void SetVector3(GLint location, const glm::vec3& value) const
+	{
+		glUniform3fv(location, 1, &value[0]);
+	}
+
+	void SetVector3Array(GLint location, const glm::vec3* values, int count) const
+	{
+		glUniform3fv(location, count, &values[0][0]);
+	}
+
+	void SetMatrix4(GLint location, const glm::mat4& mat) const
+	{
+		glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
 	}
 
 	Shader(std::string vertexPath, std::string fragmentPath)
@@ -126,11 +206,107 @@ public:
 		glLinkProgram(ID);
 		CheckCompileErrors(ID, "PROGRAM");
 
+		ReadUniformLocations();
+
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
 	}
 
 private:
+	struct UniformLocation
+	{
+		std::string name;
+		GLint location;
+	};
+
+	// Open addressing table with a power of two size, empty names mark free slots
+	std::vector<UniformLocation> uniformLocations;
+
+	// FNV-1a, uniform names are short so a simple hash spreads them well enough
+	static size_t HashUniformName(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+
+		for (; *name != '\0'; ++name)
+		{
+			hash = (hash ^ (uint8_t)*name) * 16777619u;
+		}
+
+		return hash;
+	}
+
+	void AddUniformLocation(const std::string& name, GLint location)
+	{
+		size_t mask = uniformLocations.size() - 1;
+		size_t slot = HashUniformName(name.c_str()) & mask;
+
+		while (!uniformLocations[slot].name.empty())
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		uniformLocations[slot] = { name, location };
+	}
+
+	// Stores the location of every active uniform of the linked program
+	// Arrays are reported once as "name[0]", so every element is stored on its own, and the first one also as "name" like glGetUniformLocation allows
+	void ReadUniformLocations()
+	{
+		GLint uniformCount = 0;
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+		std::vector<UniformLocation> uniforms;
+
+		for (GLint uniform = 0; uniform < uniformCount; ++uniform)
+		{
+			GLchar name[256];
+			GLsizei nameLength = 0;
+			GLint arraySize = 0;
+			GLenum type;
+
+			glGetActiveUniform(ID, uniform, sizeof(name), &nameLength, &arraySize, &type, name);
+
+			std::string uniformName(name, nameLength);
+			std::string::size_type arrayStart = uniformName.size() - 3;
+
+			if (uniformName.size() > 3 && uniformName.compare(arrayStart, 3, "[0]") == 0)
+			{
+				uniformName.erase(arrayStart);
+				uniforms.push_back({ uniformName, glGetUniformLocation(ID, uniformName.c_str()) });
+
+				for (GLint element = 0; element < arraySize; ++element)
+				{
+					std::string elementName = uniformName + "[" + std::to_string(element) + "]";
+					uniforms.push_back({ elementName, glGetUniformLocation(ID, elementName.c_str()) });
+				}
+			}
+			else
+			{
+				uniforms.push_back({ uniformName, glGetUniformLocation(ID, uniformName.c_str()) });
+			}
+		}
+
+		if (uniforms.empty())
+		{
+			return;
+		}
+
+		// At most half full, so probing stays short
+		size_t tableSize = 1;
+
+		while (tableSize < uniforms.size() * 2)
+		{
+			tableSize *= 2;
+		}
+
+		uniformLocations.resize(tableSize);
+
+		for (const UniformLocation& uniform : uniforms)
+		{
+			AddUniformLocation(uniform.name, uniform.location);
+		}
+	}
+
 	void CheckCompileErrors(GLuint shader, std::string type)
 	{
 		GLint success;
@@ -3,11 +3,9 @@ out vec4 FragColor;
 
 struct Material 
 {
-    vec3 ambient;
-    vec3 diffuse;
     vec3 specular;
     float shininess;
-	sampler2D diffuseMap;
+	sampler2DArray stickerTiles;
 }; 
 
 struct DirLight 
@@ -18,28 +16,47 @@ struct DirLight
     vec3 specular;
 };
 
+// The floats fill the gaps after the vectors, which std140 rounds up to 16 bytes
 struct PointLight 
 {
     vec3 position;
-    
     float constant;
-    float linear;
-    float quadratic;
-	
     vec3 ambient;
+    float linear;
     vec3 diffuse;
+    float quadratic;
     vec3 specular;
 };
 
 #define NR_POINT_LIGHTS 6
-uniform PointLight pointLights[NR_POINT_LIGHTS];
+
+// Written once by the program, the lights never move
+layout (std140) uniform Lights
+{
+    DirLight dirLight;
+    PointLight pointLights[NR_POINT_LIGHTS];
+};
+
+// The same block the vertex shader reads, viewPos is needed here for the specular highlights
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+
+// Colours of the cubie sides, the sides inside the cube use the last one
+#define NR_CUBIE_COLOURS 7
+uniform vec3 ambientColours[NR_CUBIE_COLOURS];
+uniform vec3 diffuseColours[NR_CUBIE_COLOURS];
+
+// Layer of the sticker tiles every colour is drawn with, set by the sticker theme
+uniform int sideLayers[NR_CUBIE_COLOURS];
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-
-uniform vec3 viewPos;
-uniform DirLight dirLight;
+flat in uint SideColour;
 
 uniform Material material;
 
@@ -52,12 +69,12 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 
 void main()
 {    
-	vec3 pixel = vec3(texture(material.diffuseMap, TexCoords));
+	vec3 pixel = vec3(texture(material.stickerTiles, vec3(TexCoords, sideLayers[SideColour])));
 	
-	if(all(lessThanEqual(pixel, vec3(1.1,1.1,1.1))) && (all(greaterThanEqual(pixel, vec3(0.9,0.9,0.9))) && material.diffuse != vec3(0,0,0)))
+	if(all(lessThanEqual(pixel, vec3(1.1,1.1,1.1))) && (all(greaterThanEqual(pixel, vec3(0.9,0.9,0.9))) && diffuseColours[SideColour] != vec3(0,0,0)))
 	{
-		ambient = material.ambient;
-		diffuse = material.diffuse;
+		ambient = ambientColours[SideColour];
+		diffuse = diffuseColours[SideColour];
 		specular = material.specular;
 	}
 	else
@@ -3,19 +3,35 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+// Per cubie, the model matrix takes up the locations 3 to 6 and the six side colours are split over 7 and 8
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in uvec4 aSideColours;
+layout (location = 8) in uvec2 aLastSideColours;
+
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out uint SideColour;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Shared with the skybox shader, the program only uploads it on frames where the camera moved
+layout (std140) uniform Camera
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    // Cubies are only rotated, moved and scaled the same along every axis, so the model matrix already turns normals the right way
+    // The fragment shader normalizes them, so the scale does not matter and no inverse is needed
+    Normal = mat3(aModel) * aNormal;
 	TexCoords = aTexCoords;
 
+	// Every side of the cube is made of 4 vertices, in the same order as the colours, and an indexed draw gets the index as gl_VertexID
+	int side = gl_VertexID / 4;
+	SideColour = side < 4 ? aSideColours[side] : aLastSideColours[side - 4];
+
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,267 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "CubeState.h"
+#include "CubeStateBatch.h"
+#include "CubeStateRank.h"
+#include "OptimalSolver.h"
+#include "TwoPhaseSolver.h"
+
+// Returns the milliseconds that passed since start
+static double GetElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Solves a fixed set of randomly scrambled cubes on one thread and prints how long it took
+// Building the tables is timed on its own, so the solve times only contain the search
+// Solutions longer than the target length are counted, they mean the node limit ran out first
+static void RunSolverBenchmark(int scrambleCount, int targetLength = 20)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	TwoPhaseSolver solver;
+	double tableTime = GetElapsedMilliseconds(start);
+
+	// Fixed seed, so every run solves the same cubes
+	std::mt19937 random(1);
+	std::vector<double> solveTimes;
+	int totalLength = 0;
+	int longestSolution = 0;
+	int failedSolves = 0;
+	int longSolutions = 0;
+
+	for (int i = 0; i < scrambleCount; ++i)
+	{
+		CubeState state;
+
+		for (int move = 0; move < 40; ++move)
+		{
+			state.ApplyMove(random() % 18);
+		}
+
+		bool solved = false;
+
+		start = std::chrono::steady_clock::now();
+		std::vector<int> solution = solver.Solve(state, targetLength, defaultTwoPhaseNodeLimit, &solved);
+		solveTimes.push_back(GetElapsedMilliseconds(start));
+
+		state.ApplyMoves(solution.data(), (int)solution.size());
+
+		if (!solved || !state.IsSolved())
+		{
+			++failedSolves;
+		}
+
+		if ((int)solution.size() > targetLength)
+		{
+			++longSolutions;
+		}
+
+		totalLength += (int)solution.size();
+		longestSolution = std::max(longestSolution, (int)solution.size());
+	}
+
+	std::sort(solveTimes.begin(), solveTimes.end());
+
+	std::cout << "Tables built in " << tableTime << " ms" << std::endl;
+	std::cout << "Solved " << scrambleCount << " cubes, " << failedSolves << " failed" << std::endl;
+	std::cout << "Median " << solveTimes[scrambleCount / 2] << " ms, 90th percentile " << solveTimes[scrambleCount * 9 / 10] << " ms, slowest " << solveTimes.back() << " ms" << std::endl;
+	std::cout << "Average length " << (float)totalLength / scrambleCount << " moves, longest " << longestSolution << " moves" << std::endl;
+	std::cout << longSolutions << " solutions longer than " << targetLength << " moves" << std::endl;
+
+	// Cubes a few moves from solved, where some search directions start inside the phase 1 subgroup and others do not
+	// A solve fails if it finds nothing, does not solve the cube or is longer than the target, it stops at the first solution within the target like any other
+	int shortScrambleCount = 0;
+	int failedShortSolves = 0;
+	double slowestShortSolve = 0.0;
+
+	for (int scrambleLength = 1; scrambleLength <= 3; ++scrambleLength)
+	{
+		for (int i = 0; i < (scrambleLength == 1 ? 18 : 100); ++i)
+		{
+			CubeState state;
+
+			for (int move = 0; move < scrambleLength; ++move)
+			{
+				state.ApplyMove(scrambleLength == 1 ? i : random() % 18);
+			}
+
+			bool solved = false;
+
+			start = std::chrono::steady_clock::now();
+			std::vector<int> solution = solver.Solve(state, targetLength, defaultTwoPhaseNodeLimit, &solved);
+			slowestShortSolve = std::max(slowestShortSolve, GetElapsedMilliseconds(start));
+
+			state.ApplyMoves(solution.data(), (int)solution.size());
+
+			if (!solved || !state.IsSolved() || (int)solution.size() > targetLength)
+			{
+				++failedShortSolves;
+			}
+
+			++shortScrambleCount;
+		}
+	}
+
+	std::cout << "Solved " << shortScrambleCount << " cubes scrambled with 1 to 3 moves, " << failedShortSolves << " failed, slowest " << slowestShortSolve << " ms" << std::endl;
+}
+
+// Solves cubes scrambled with a given number of random moves optimally, using every core
+// Random cubes need about 18 moves and can take hours, so shorter scrambles keep the run practical
+static void RunOptimalSolverBenchmark(int scrambleCount, int scrambleLength)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	OptimalSolver solver;
+	std::cout << "Pattern databases built in " << GetElapsedMilliseconds(start) / 1000.0 << " s, searching with " << solver.threadCount << " threads" << std::endl;
+
+	std::mt19937 random(1);
+	int64_t totalNodes = 0;
+	double totalTime = 0.0;
+
+	for (int i = 0; i < scrambleCount; ++i)
+	{
+		CubeState state;
+
+		for (int move = 0; move < scrambleLength; ++move)
+		{
+			state.ApplyMove(random() % 18);
+		}
+
+		std::vector<int> solution = solver.Solve(state);
+
+		state.ApplyMoves(solution.data(), (int)solution.size());
+
+		std::cout << "Cube " << i + 1 << ": " << solution.size() << " moves" << (state.IsSolved() ? "" : " (wrong)") << " in " << solver.solveTime << " s, ";
+		std::cout << solver.nodeCount << " nodes, " << solver.GetNodesPerSecond() / 1000000.0 << " million nodes/s" << std::endl;
+
+		totalNodes += solver.nodeCount;
+		totalTime += solver.solveTime;
+	}
+
+	std::cout << "Total " << totalNodes << " nodes in " << totalTime << " s, " << (totalTime > 0.0 ? totalNodes / totalTime / 1000000.0 : 0.0) << " million nodes/s" << std::endl;
+}
+
+// Applies the same random algorithm to many random states, once per state with CubeState and once per block of states with CubeStateBatch
+// Both results are compared, so the batch is checked against the scalar moves on every run
+static void RunMoveBenchmark(int stateCount, int algorithmLength)
+{
+	std::mt19937 random(1);
+	std::vector<CubeState> states(stateCount);
+	CubeStateBatch batch(stateCount);
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		for (int move = 0; move < 40; ++move)
+		{
+			states[i].ApplyMove(random() % 18);
+		}
+
+		batch.SetState(i, states[i]);
+	}
+
+	std::vector<int> algorithm(algorithmLength);
+
+	for (int& move : algorithm)
+	{
+		move = random() % 18;
+	}
+
+	CubeStateBatch combinedBatch = batch;
+	double moveCount = (double)stateCount * algorithmLength;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (CubeState& state : states)
+	{
+		state.ApplyMoves(algorithm.data(), algorithmLength);
+	}
+
+	double scalarTime = GetElapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	batch.ApplyMoves(algorithm.data(), algorithmLength);
+	double batchTime = GetElapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	combinedBatch.ApplyAlgorithm(algorithm.data(), algorithmLength);
+	double combinedTime = GetElapsedMilliseconds(start);
+
+	int mismatches = 0;
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		if (batch.GetState(i) != states[i] || combinedBatch.GetState(i) != states[i])
+		{
+			++mismatches;
+		}
+	}
+
+	std::cout << "Applied " << algorithmLength << " moves to " << stateCount << " cubes, " << mismatches << " mismatches" << std::endl;
+	std::cout << "CubeState " << scalarTime << " ms, " << moveCount / scalarTime / 1000.0 << " million moves/s" << std::endl;
+	std::cout << "CubeStateBatch " << batchTime << " ms, " << moveCount / batchTime / 1000.0 << " million moves/s" << std::endl;
+	std::cout << "CubeStateBatch combined " << combinedTime << " ms, " << moveCount / combinedTime / 1000.0 << " million moves/s" << std::endl;
+}
+
+// Ranks many random states one at a time and a block at a time, then turns the ranks back into states
+// Every rank is checked against the other version and against the state it came from
+static void RunRankBenchmark(int stateCount)
+{
+	std::mt19937 random(1);
+	std::vector<CubeState> states(stateCount);
+	CubeStateBatch batch(stateCount);
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		for (int move = 0; move < 40; ++move)
+		{
+			states[i].ApplyMove(random() % 18);
+		}
+
+		batch.SetState(i, states[i]);
+	}
+
+	std::vector<CubeStateRank> ranks(stateCount);
+	std::vector<CubeStateRank> batchRanks(stateCount);
+	std::vector<CubeState> unrankedStates(stateCount);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		ranks[i] = RankCubeState(states[i]);
+	}
+
+	double scalarTime = GetElapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	RankCubeStateBatch(batch, batchRanks.data());
+	double batchTime = GetElapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		unrankedStates[i] = UnrankCubeState(ranks[i]);
+	}
+
+	double unrankTime = GetElapsedMilliseconds(start);
+
+	int mismatches = 0;
+
+	for (int i = 0; i < stateCount; ++i)
+	{
+		if (batchRanks[i] != ranks[i] || unrankedStates[i] != states[i])
+		{
+			++mismatches;
+		}
+	}
+
+	std::cout << "Ranked " << stateCount << " cubes, " << mismatches << " mismatches" << std::endl;
+	std::cout << "RankCubeState " << scalarTime << " ms, " << stateCount / scalarTime / 1000.0 << " million ranks/s" << std::endl;
+	std::cout << "RankCubeStateBatch " << batchTime << " ms, " << stateCount / batchTime / 1000.0 << " million ranks/s" << std::endl;
+	std::cout << "UnrankCubeState " << unrankTime << " ms, " << stateCount / unrankTime / 1000.0 << " million states/s" << std::endl;
+}
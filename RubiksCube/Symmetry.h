@@ -0,0 +1,210 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "CubeState.h"
+
+// The 16 symmetries of the cube that keep the U-D axis in place, four quarter turns around it, the half turn that swaps U and D,
+// and the mirror image that swaps L and R
+// A cube and its conjugate S * cube * S^-1 are the same distance away from any subgroup these symmetries keep in place,
+// so tables over such subgroups only need one entry for each class of conjugate cubes
+
+static const int symmetryCount = 16;
+
+// A cube that may be mirrored, corner twists from 3 to 5 belong to mirrored corners
+struct SymmetryCube
+{
+	std::array<uint8_t, 8> cornerSource;
+	std::array<uint8_t, 8> cornerTwist;
+	std::array<uint8_t, 12> edgeSource;
+	std::array<uint8_t, 12> edgeFlip;
+};
+
+static SymmetryCube GetSymmetryCube(const CubeState& state)
+{
+	SymmetryCube cube;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		cube.cornerSource[i] = state.corners[i] / 3;
+		cube.cornerTwist[i] = state.corners[i] % 3;
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		cube.edgeSource[i] = state.edges[i] / 2;
+		cube.edgeFlip[i] = state.edges[i] % 2;
+	}
+
+	return cube;
+}
+
+// Only valid for cubes that are not mirrored, which every conjugate of a real cube is
+static CubeState GetCubeState(const SymmetryCube& cube)
+{
+	CubeState state;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		state.corners[i] = cube.cornerSource[i] * 3 + cube.cornerTwist[i];
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		state.edges[i] = cube.edgeSource[i] * 2 + cube.edgeFlip[i];
+	}
+
+	return state;
+}
+
+// Chains two cubes like CombineCubeMoves, a mirror on either side turns the twists of the other around
+static SymmetryCube MultiplySymmetryCubes(const SymmetryCube& first, const SymmetryCube& second)
+{
+	SymmetryCube result;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		int firstTwist = first.cornerTwist[second.cornerSource[i]];
+		int secondTwist = second.cornerTwist[i];
+		int twist;
+
+		if (firstTwist < 3 && secondTwist < 3)
+		{
+			twist = (firstTwist + secondTwist) % 3;
+		}
+		else if (firstTwist < 3)
+		{
+			twist = firstTwist + secondTwist >= 6 ? firstTwist + secondTwist - 3 : firstTwist + secondTwist;
+		}
+		else if (secondTwist < 3)
+		{
+			twist = firstTwist - secondTwist < 3 ? firstTwist - secondTwist + 3 : firstTwist - secondTwist;
+		}
+		else
+		{
+			twist = firstTwist - secondTwist < 0 ? firstTwist - secondTwist + 3 : firstTwist - secondTwist;
+		}
+
+		result.cornerSource[i] = first.cornerSource[second.cornerSource[i]];
+		result.cornerTwist[i] = twist;
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		result.edgeSource[i] = first.edgeSource[second.edgeSource[i]];
+		result.edgeFlip[i] = first.edgeFlip[second.edgeSource[i]] ^ second.edgeFlip[i];
+	}
+
+	return result;
+}
+
+// The three symmetries every other one is built from
+// Half turn around the F-B axis
+static const SymmetryCube symmetryF2 =
+{
+	{ DLF, DFR, DRB, DBL, UFL, URF, UBR, ULB }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+	{ DL, DF, DR, DB, UL, UF, UR, UB, FL, FR, BR, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+};
+
+// Quarter turn around the U-D axis
+static const SymmetryCube symmetryU4 =
+{
+	{ UBR, URF, UFL, ULB, DRB, DFR, DLF, DBL }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+	{ UB, UR, UF, UL, DB, DR, DF, DL, BR, FR, FL, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 }
+};
+
+// Mirror image through the plane between L and R
+static const SymmetryCube symmetryLR2 =
+{
+	{ UFL, URF, UBR, ULB, DLF, DFR, DRB, DBL }, { 3, 3, 3, 3, 3, 3, 3, 3 },
+	{ UL, UF, UR, UB, DL, DF, DR, DB, FL, FR, BR, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+};
+
+// Third of a turn around the diagonal through URF and DBL
+// It is not one of the 16, it moves the U-D axis onto another axis, so the two-phase solver uses it to search the cube from every axis
+static const SymmetryCube symmetryURF3 =
+{
+	{ URF, DFR, DLF, UFL, UBR, DRB, DBL, ULB }, { 1, 2, 1, 2, 2, 1, 2, 1 },
+	{ UF, FR, DF, FL, UB, BR, DB, BL, UR, DR, DL, UL }, { 1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1 }
+};
+
+struct SymmetryGroup
+{
+	std::array<SymmetryCube, symmetryCount> symmetries;
+	std::array<uint8_t, symmetryCount> inverses;
+};
+
+// Symmetry 0 is the identity, the others follow as mirror, then quarter turns, then half turn
+static SymmetryGroup BuildSymmetryGroup()
+{
+	SymmetryGroup group;
+	SymmetryCube symmetry = GetSymmetryCube(CubeState());
+	int index = 0;
+
+	for (int f2 = 0; f2 < 2; ++f2)
+	{
+		for (int u4 = 0; u4 < 4; ++u4)
+		{
+			for (int lr2 = 0; lr2 < 2; ++lr2)
+			{
+				group.symmetries[index++] = symmetry;
+				symmetry = MultiplySymmetryCubes(symmetry, symmetryLR2);
+			}
+
+			symmetry = MultiplySymmetryCubes(symmetry, symmetryU4);
+		}
+
+		symmetry = MultiplySymmetryCubes(symmetry, symmetryF2);
+	}
+
+	SymmetryCube identity = GetSymmetryCube(CubeState());
+
+	for (int i = 0; i < symmetryCount; ++i)
+	{
+		for (int j = 0; j < symmetryCount; ++j)
+		{
+			SymmetryCube product = MultiplySymmetryCubes(group.symmetries[i], group.symmetries[j]);
+
+			if (product.cornerSource == identity.cornerSource && product.cornerTwist == identity.cornerTwist && product.edgeSource == identity.edgeSource && product.edgeFlip == identity.edgeFlip)
+			{
+				group.inverses[i] = j;
+			}
+		}
+	}
+
+	return group;
+}
+
+static const SymmetryGroup symmetryGroup = BuildSymmetryGroup();
+
+// Returns S * state * S^-1 for any symmetry S that is not mirrored
+static CubeState ConjugateCubeState(const CubeState& state, const SymmetryCube& symmetry, const SymmetryCube& inverse)
+{
+	return GetCubeState(MultiplySymmetryCubes(MultiplySymmetryCubes(symmetry, GetSymmetryCube(state)), inverse));
+}
+
+// Returns S * state * S^-1 for one of the 16 symmetries
+static CubeState ConjugateCubeState(const CubeState& state, int symmetry)
+{
+	SymmetryCube cube = MultiplySymmetryCubes(symmetryGroup.symmetries[symmetry], GetSymmetryCube(state));
+
+	return GetCubeState(MultiplySymmetryCubes(cube, symmetryGroup.symmetries[symmetryGroup.inverses[symmetry]]));
+}
+
+// The cube that undoes state, every piece goes back to the slot it came from with its twist or flip undone
+static CubeState GetInverseCubeState(const CubeState& state)
+{
+	CubeState inverse;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		inverse.corners[state.corners[i] / 3] = i * 3 + (3 - state.corners[i] % 3) % 3;
+	}
+
+	for (int i = 0; i < 12; ++i)
+	{
+		inverse.edges[state.edges[i] / 2] = i * 2 + state.edges[i] % 2;
+	}
+
+	return inverse;
+}
@@ -0,0 +1,789 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "CubeState.h"
+#include "PruningTable.h"
+#include "Symmetry.h"
+
+// Kociemba's two-phase algorithm
+// Phase 1 brings the cube into the subgroup <U, D, R2, F2, L2, B2>, where every piece is oriented and the four middle edges sit in the middle layer
+// Phase 2 solves the cube using only the moves of that subgroup
+// Both phases are IDA* searches over small coordinates, so all the work is done with table lookups instead of on the cube itself
+
+static const int twistCount = 2187;
+static const int flipCount = 2048;
+static const int sliceCount = 495;
+static const int cornerPermutationCount = 40320;
+static const int edgePermutationCount = 40320;
+static const int slicePermutationCount = 24;
+static const int flipSliceCount = flipCount * sliceCount;
+
+// The moves that keep the cube inside the phase 2 subgroup, as indices into cubeMoveTable
+static const int phase2Moves[10] = { 0, 1, 2, 4, 7, 9, 10, 11, 13, 16 };
+
+static bool IsPhase2Move(int move)
+{
+	int face = move / 3;
+
+	return face == UFACE || face == DFACE || move % 3 == 1;
+}
+
+// Orientation of the first seven corners in base 3, the last one follows from them
+static int GetTwist(const CubeState& state)
+{
+	int twist = 0;
+
+	for (int i = URF; i < DRB; ++i)
+	{
+		twist = twist * 3 + state.corners[i] % 3;
+	}
+
+	return twist;
+}
+
+// Orientation of the first eleven edges in base 2, the last one follows from them
+static int GetFlip(const CubeState& state)
+{
+	int flip = 0;
+
+	for (int i = UR; i < BR; ++i)
+	{
+		flip = flip * 2 + state.edges[i] % 2;
+	}
+
+	return flip;
+}
+
+// Which four of the twelve edge slots hold the middle layer edges, ignoring their order
+// The solved cube has them in the last four slots, which gives 0
+static int GetSlice(const CubeState& state)
+{
+	int slice = 0;
+	int found = 0;
+
+	for (int i = BR; i >= UR; --i)
+	{
+		if (state.edges[i] / 2 >= FR)
+		{
+			// Binomial coefficient C(BR - i, found + 1)
+			int n = BR - i;
+			int k = found + 1;
+			int binomial = n < k ? 0 : 1;
+
+			for (int j = 0; j < k && n >= k; ++j)
+			{
+				binomial = binomial * (n - j) / (j + 1);
+			}
+
+			slice += binomial;
+			++found;
+		}
+	}
+
+	return slice;
+}
+
+// Lehmer code of a permutation, the identity gives 0
+static int GetPermutationIndex(const uint8_t* pieces, int count)
+{
+	int index = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		int smaller = 0;
+
+		for (int j = i + 1; j < count; ++j)
+		{
+			if (pieces[j] < pieces[i])
+			{
+				++smaller;
+			}
+		}
+
+		index = index * (count - i) + smaller;
+	}
+
+	return index;
+}
+
+static int GetCornerPermutation(const CubeState& state)
+{
+	uint8_t pieces[8];
+
+	for (int i = 0; i < 8; ++i)
+	{
+		pieces[i] = state.corners[i] / 3;
+	}
+
+	return GetPermutationIndex(pieces, 8);
+}
+
+// Only meaningful in phase 2, where the first eight edge slots hold the eight edges of the U and D layers
+static int GetEdgePermutation(const CubeState& state)
+{
+	uint8_t pieces[8];
+
+	for (int i = 0; i < 8; ++i)
+	{
+		pieces[i] = state.edges[i] / 2;
+	}
+
+	return GetPermutationIndex(pieces, 8);
+}
+
+// Only meaningful in phase 2, where the middle layer edges stay in the middle layer
+static int GetSlicePermutation(const CubeState& state)
+{
+	uint8_t pieces[4];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		pieces[i] = state.edges[FR + i] / 2;
+	}
+
+	return GetPermutationIndex(pieces, 4);
+}
+
+// For every value of a coordinate and every move, the value after the move
+// Built by a breadth first search from the solved cube, so no coordinate ever has to be turned back into a cube
+// Moves that are not searched stay at 0
+template<typename Coordinate>
+static std::vector<uint16_t> BuildCoordinateMoveTable(int size, Coordinate coordinate, const int* moves, int moveCount)
+{
+	std::vector<uint16_t> table(size * 18, 0);
+	std::vector<CubeState> representatives(size);
+	std::vector<bool> found(size, false);
+	std::vector<int> order;
+
+	order.reserve(size);
+	order.push_back(coordinate(CubeState()));
+	found[order[0]] = true;
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		int value = order[i];
+
+		for (int m = 0; m < moveCount; ++m)
+		{
+			CubeState next = representatives[value];
+			next.ApplyMove(moves[m]);
+
+			int nextValue = coordinate(next);
+			table[value * 18 + moves[m]] = nextValue;
+
+			if (!found[nextValue])
+			{
+				found[nextValue] = true;
+				representatives[nextValue] = next;
+				order.push_back(nextValue);
+			}
+		}
+	}
+
+	return table;
+}
+
+// Distance to the solved pair of coordinates for every pair, the combined index is first * secondSize + second
+// Filled one depth at a time, 0xFF marks pairs that have not been reached yet
+static std::vector<uint8_t> BuildPruningTable(const std::vector<uint16_t>& firstMoves, int firstSize, const std::vector<uint16_t>& secondMoves, int secondSize, const int* moves, int moveCount)
+{
+	int size = firstSize * secondSize;
+	std::vector<uint8_t> table(size, 0xFF);
+
+	table[0] = 0;
+	int reached = 1;
+
+	for (uint8_t depth = 0; reached < size; ++depth)
+	{
+		for (int index = 0; index < size; ++index)
+		{
+			if (table[index] != depth)
+			{
+				continue;
+			}
+
+			int first = index / secondSize;
+			int second = index % secondSize;
+
+			for (int m = 0; m < moveCount; ++m)
+			{
+				int next = firstMoves[first * 18 + moves[m]] * secondSize + secondMoves[second * 18 + moves[m]];
+
+				if (table[next] == 0xFF)
+				{
+					table[next] = depth + 1;
+					++reached;
+				}
+			}
+		}
+	}
+
+	return table;
+}
+
+// Flip and slice together are reduced by the 16 symmetries that keep the U-D axis, which also keep the phase 1 subgroup
+// The 1013760 combinations fall into 64430 classes, so a phase 1 table over flip, slice and twist shrinks from over 1 GB to 70 MB
+struct FlipSliceSymmetry
+{
+	// For every flip and slice, the class it belongs to and the symmetry that turns it into the representative of the class
+	std::vector<uint32_t> classes;
+	std::vector<uint8_t> symmetries;
+
+	// Flip and slice of the representative of every class
+	std::vector<uint32_t> representatives;
+
+	// For every class, one bit for each symmetry that turns the representative into itself
+	// A cube with such a representative has conjugates with the same flip and slice but a different twist, which all need the same distance
+	std::vector<uint16_t> representativeSymmetries;
+
+	// The twist of S * cube * S^-1 for every twist and symmetry, the twist of a conjugate only depends on the twist
+	std::vector<uint16_t> twistConjugates;
+
+	FlipSliceSymmetry()
+	{
+		// A cube with the middle layer edges in each of the 495 combinations of slots
+		std::vector<CubeState> sliceCubes(sliceCount);
+
+		for (int slots = 0; slots < 1 << 12; ++slots)
+		{
+			int sliceEdge = FR;
+			int otherEdge = UR;
+			CubeState state;
+
+			for (int slot = 0; slot < 12; ++slot)
+			{
+				state.edges[slot] = ((slots >> slot) & 1 ? sliceEdge++ : otherEdge++) * 2;
+			}
+
+			if (sliceEdge == BR + 1)
+			{
+				sliceCubes[GetSlice(state)] = state;
+			}
+		}
+
+		classes.assign(flipSliceCount, UINT32_MAX);
+		symmetries.assign(flipSliceCount, 0);
+
+		for (int flipSlice = 0; flipSlice < flipSliceCount; ++flipSlice)
+		{
+			if (classes[flipSlice] != UINT32_MAX)
+			{
+				continue;
+			}
+
+			CubeState state = sliceCubes[flipSlice / flipCount];
+			int flip = flipSlice % flipCount;
+			int parity = 0;
+
+			for (int slot = BR - 1; slot >= UR; --slot, flip >>= 1)
+			{
+				state.edges[slot] = state.edges[slot] / 2 * 2 + (flip & 1);
+				parity ^= flip & 1;
+			}
+
+			state.edges[BR] = state.edges[BR] / 2 * 2 + parity;
+
+			uint16_t selfSymmetries = 0;
+
+			for (int symmetry = 0; symmetry < symmetryCount; ++symmetry)
+			{
+				CubeState conjugate = ConjugateCubeState(state, symmetry);
+				int conjugateFlipSlice = GetSlice(conjugate) * flipCount + GetFlip(conjugate);
+
+				if (classes[conjugateFlipSlice] == UINT32_MAX)
+				{
+					classes[conjugateFlipSlice] = (uint32_t)representatives.size();
+					symmetries[conjugateFlipSlice] = symmetryGroup.inverses[symmetry];
+				}
+
+				if (conjugateFlipSlice == flipSlice)
+				{
+					selfSymmetries |= 1 << symmetry;
+				}
+			}
+
+			representatives.push_back(flipSlice);
+			representativeSymmetries.push_back(selfSymmetries);
+		}
+
+		twistConjugates.resize(twistCount * symmetryCount);
+
+		for (int twist = 0; twist < twistCount; ++twist)
+		{
+			CubeState state;
+			int remainingTwist = twist;
+			int twistSum = 0;
+
+			for (int slot = DRB - 1; slot >= URF; --slot, remainingTwist /= 3)
+			{
+				state.corners[slot] = slot * 3 + remainingTwist % 3;
+				twistSum += remainingTwist % 3;
+			}
+
+			state.corners[DRB] = DRB * 3 + (3 - twistSum % 3) % 3;
+
+			for (int symmetry = 0; symmetry < symmetryCount; ++symmetry)
+			{
+				twistConjugates[twist * symmetryCount + symmetry] = GetTwist(ConjugateCubeState(state, symmetry));
+			}
+		}
+	}
+
+	// Index into the phase 1 table, the same for every cube in a class of conjugates
+	int GetIndex(int twist, int flip, int slice) const
+	{
+		int flipSlice = slice * flipCount + flip;
+
+		return classes[flipSlice] * twistCount + twistConjugates[twist * symmetryCount + symmetries[flipSlice]];
+	}
+
+	// Sets an entry of the phase 1 table and every entry of the same class that belongs to a conjugate of the same cube
+	// Returns how many entries were new
+	int SetDistance(PatternDatabaseBuilder& builder, int index, int distance) const
+	{
+		int flipSliceClass = index / twistCount;
+		int twist = index % twistCount;
+		int newEntries = 0;
+
+		for (int symmetry = 0; symmetry < symmetryCount; ++symmetry)
+		{
+			if ((representativeSymmetries[flipSliceClass] >> symmetry) & 1)
+			{
+				newEntries += builder.TrySet(flipSliceClass * twistCount + twistConjugates[twist * symmetryCount + symmetry], distance);
+			}
+		}
+
+		return newEntries;
+	}
+};
+
+// The solver searches the cube from each of its three axes, and its inverse the same way
+// Each of the six looks like a different cube to phase 1, and the shortest solution is often only found from one of them
+static const int searchDirectionCount = 6;
+
+// Turns the cube so that the axis of the given direction becomes the U-D axis, and inverts it for the last three directions
+static CubeState GetSearchDirectionState(const CubeState& state, int direction)
+{
+	CubeState directionState = direction < 3 ? state : GetInverseCubeState(state);
+	SymmetryCube inverseRotation = MultiplySymmetryCubes(symmetryURF3, symmetryURF3);
+
+	for (int turn = 0; turn < direction % 3; ++turn)
+	{
+		directionState = ConjugateCubeState(directionState, symmetryURF3, inverseRotation);
+	}
+
+	return directionState;
+}
+
+// Every table both phases need, about 80 MB in total
+struct TwoPhaseTables
+{
+	std::vector<uint16_t> twistMoves;
+	std::vector<uint16_t> flipMoves;
+	std::vector<uint16_t> sliceMoves;
+	std::vector<uint16_t> cornerPermutationMoves;
+	std::vector<uint16_t> edgePermutationMoves;
+	std::vector<uint16_t> slicePermutationMoves;
+
+	FlipSliceSymmetry flipSliceSymmetry;
+
+	// Distances packed two to a byte, indexed by FlipSliceSymmetry::GetIndex
+	PruningTable flipSliceTwistPruning;
+
+	PruningTable cornerSlicePruning;
+	PruningTable edgeSlicePruning;
+
+	// For every search direction and move, the move of the cube itself that it stands for
+	std::array<std::array<uint8_t, 18>, 3> directionMoves;
+
+	TwoPhaseTables()
+	{
+		int allMoves[18];
+
+		for (int m = 0; m < 18; ++m)
+		{
+			allMoves[m] = m;
+		}
+
+		twistMoves = BuildCoordinateMoveTable(twistCount, GetTwist, allMoves, 18);
+		flipMoves = BuildCoordinateMoveTable(flipCount, GetFlip, allMoves, 18);
+		sliceMoves = BuildCoordinateMoveTable(sliceCount, GetSlice, allMoves, 18);
+		cornerPermutationMoves = BuildCoordinateMoveTable(cornerPermutationCount, GetCornerPermutation, phase2Moves, 10);
+		edgePermutationMoves = BuildCoordinateMoveTable(edgePermutationCount, GetEdgePermutation, phase2Moves, 10);
+		slicePermutationMoves = BuildCoordinateMoveTable(slicePermutationCount, GetSlicePermutation, phase2Moves, 10);
+
+		// A move seen from a turned cube is the move that turns into it, which is found by turning every move back
+		for (int direction = 0; direction < 3; ++direction)
+		{
+			for (int move = 0; move < 18; ++move)
+			{
+				CubeState moveState;
+				moveState.ApplyMove(move);
+				moveState = GetSearchDirectionState(moveState, direction);
+
+				for (int cubeMove = 0; cubeMove < 18; ++cubeMove)
+				{
+					CubeState cubeMoveState;
+					cubeMoveState.ApplyMove(cubeMove);
+
+					if (cubeMoveState == moveState)
+					{
+						directionMoves[direction][cubeMove] = move;
+					}
+				}
+			}
+		}
+
+		// The pruning tables are read from their files, they are only generated if a file is missing
+		// The phase 1 table is searched one class at a time, starting from the representative of each class
+		int flipSliceTwistCount = (int)flipSliceSymmetry.representatives.size() * twistCount;
+
+		flipSliceTwistPruning = LoadPruningTable("TwoPhaseFlipSliceTwist", 2, (flipSliceTwistCount + 1) / 2, [&]()
+		{
+			return PatternDatabaseBuilder(flipSliceTwistCount).Build(0, GetDefaultThreadCount(), [this](PatternDatabaseBuilder& builder, int index, int distance)
+			{
+				int flipSlice = flipSliceSymmetry.representatives[index / twistCount];
+				int twist = index % twistCount;
+				int flip = flipSlice % flipCount;
+				int slice = flipSlice / flipCount;
+				int newEntries = 0;
+
+				for (int move = 0; move < 18; ++move)
+				{
+					newEntries += flipSliceSymmetry.SetDistance(builder, flipSliceSymmetry.GetIndex(twistMoves[twist * 18 + move], flipMoves[flip * 18 + move], sliceMoves[slice * 18 + move]), distance);
+				}
+
+				return newEntries;
+			});
+		});
+
+		cornerSlicePruning = LoadPruningTable("TwoPhaseCornerSlice", 1, cornerPermutationCount * slicePermutationCount, [&]()
+		{
+			return BuildPruningTable(cornerPermutationMoves, cornerPermutationCount, slicePermutationMoves, slicePermutationCount, phase2Moves, 10);
+		});
+
+		edgeSlicePruning = LoadPruningTable("TwoPhaseEdgeSlice", 1, edgePermutationCount * slicePermutationCount, [&]()
+		{
+			return BuildPruningTable(edgePermutationMoves, edgePermutationCount, slicePermutationMoves, slicePermutationCount, phase2Moves, 10);
+		});
+	}
+
+	int GetPhase1Distance(int twist, int flip, int slice) const
+	{
+		int index = flipSliceSymmetry.GetIndex(twist, flip, slice);
+
+		return (flipSliceTwistPruning[index / 2] >> (index % 2 * 4)) & 15;
+	}
+
+	// Walks randomly through the phase 1 coordinates and counts the cubes whose distance does not fit their neighbours
+	// A move changes the distance by at most 1, and every cube that is not in the subgroup has a neighbour that is 1 closer
+	int CountPhase1Inconsistencies(int cubeCount, uint32_t seed = 1) const
+	{
+		std::mt19937 random(seed);
+		int twist = 0;
+		int flip = 0;
+		int slice = 0;
+		int inconsistencies = 0;
+
+		for (int i = 0; i < cubeCount; ++i)
+		{
+			int move = random() % 18;
+
+			twist = twistMoves[twist * 18 + move];
+			flip = flipMoves[flip * 18 + move];
+			slice = sliceMoves[slice * 18 + move];
+
+			int distance = GetPhase1Distance(twist, flip, slice);
+			int closestNeighbour = 15;
+			bool consistent = true;
+
+			for (int m = 0; m < 18; ++m)
+			{
+				int neighbourDistance = GetPhase1Distance(twistMoves[twist * 18 + m], flipMoves[flip * 18 + m], sliceMoves[slice * 18 + m]);
+
+				closestNeighbour = std::min(closestNeighbour, neighbourDistance);
+				consistent = consistent && std::abs(neighbourDistance - distance) <= 1;
+			}
+
+			if (!consistent || (distance > 0 && closestNeighbour != distance - 1))
+			{
+				++inconsistencies;
+			}
+		}
+
+		return inconsistencies;
+	}
+};
+
+// The tables are built the first time a solver needs them and shared by every solver after that
+static const TwoPhaseTables& GetTwoPhaseTables()
+{
+	static const TwoPhaseTables tables;
+
+	return tables;
+}
+
+// Enough for almost every random cube to reach 20 moves, most need far fewer
+static const int64_t defaultTwoPhaseNodeLimit = 2000000;
+
+// Finds short solutions, returned as indices into cubeMoveTable
+// The first solution usually comes quickly but is a few moves too long, so the search keeps going for shorter ones
+// until it reaches the target length or runs out of nodes, and the best solution found is returned
+// Every phase 1 length is searched in all six directions before the next one, so no direction uses up the nodes on its own
+// The tables are shared, everything else lives in the solver, so every thread can use its own solver
+struct TwoPhaseSolver
+{
+	const TwoPhaseTables& tables;
+
+	// Nodes visited by the last call to Solve, in both phases
+	int64_t nodeCount = 0;
+
+	TwoPhaseSolver() : tables(GetTwoPhaseTables())
+	{
+	}
+
+	// Returns an empty solution if the cube is already solved or no solution was found within the node limit
+	// solved is set accordingly
+	std::vector<int> Solve(const CubeState& state, int targetLength = 20, int64_t nodeLimit = defaultTwoPhaseNodeLimit, bool* solved = nullptr)
+	{
+		this->targetLength = targetLength;
+		this->nodeLimit = nodeLimit;
+		maxLength = std::min(targetLength + 2, (int)path.size() - 1);
+		solutionLength = -1;
+		nodeCount = 0;
+
+		std::array<CubeState, searchDirectionCount> directionStates;
+		std::array<int, searchDirectionCount> twists;
+		std::array<int, searchDirectionCount> flips;
+		std::array<int, searchDirectionCount> slices;
+		std::array<int, searchDirectionCount> phase1Distances;
+		int shortestPhase1Length = maxLength + 1;
+
+		for (int direction = 0; direction < searchDirectionCount; ++direction)
+		{
+			directionStates[direction] = GetSearchDirectionState(state, direction);
+			twists[direction] = GetTwist(directionStates[direction]);
+			flips[direction] = GetFlip(directionStates[direction]);
+			slices[direction] = GetSlice(directionStates[direction]);
+			phase1Distances[direction] = GetPhase1Distance(twists[direction], flips[direction], slices[direction]);
+			shortestPhase1Length = std::min(shortestPhase1Length, phase1Distances[direction]);
+		}
+
+		for (int phase1Length = shortestPhase1Length; phase1Length <= maxLength && !IsDone(); ++phase1Length)
+		{
+			for (int direction = 0; direction < searchDirectionCount && !IsDone(); ++direction)
+			{
+				// A direction further from the subgroup than phase1Length has no phase 1 solution of that length
+				if (phase1Distances[direction] > phase1Length)
+				{
+					continue;
+				}
+
+				startState = directionStates[direction];
+				searchDirection = direction;
+
+				SearchPhase1(twists[direction], flips[direction], slices[direction], 0, phase1Length);
+			}
+		}
+
+		if (solved != nullptr)
+		{
+			*solved = solutionLength >= 0;
+		}
+
+		return GetSolution();
+	}
+
+private:
+
+	CubeState startState;
+	int searchDirection = 0;
+	int targetLength = 20;
+	int64_t nodeLimit = 0;
+
+	// Only solutions of at most maxLength moves are searched, it drops every time a solution is found
+	int maxLength = 0;
+	int solutionLength = -1;
+
+	std::array<int, 32> path;
+	std::array<int, 32> solution;
+	int solutionDirection = 0;
+
+	// Turns the moves of the best solution back into moves of the cube that was passed to Solve
+	std::vector<int> GetSolution() const
+	{
+		std::vector<int> moves;
+
+		for (int i = 0; i < solutionLength; ++i)
+		{
+			moves.push_back(tables.directionMoves[solutionDirection % 3][solution[i]]);
+		}
+
+		// A solution of the inverse cube, played backwards with every move undone, solves the cube
+		if (solutionDirection >= 3)
+		{
+			std::reverse(moves.begin(), moves.end());
+
+			for (int& move : moves)
+			{
+				move = move - move % 3 + 2 - move % 3;
+			}
+		}
+
+		return moves;
+	}
+
+	// The node limit also stops a search that has not found any solution yet, Solve then returns an empty one
+	bool IsDone() const
+	{
+		return (solutionLength >= 0 && solutionLength <= targetLength) || nodeCount >= nodeLimit;
+	}
+
+	int GetPhase1Distance(int twist, int flip, int slice) const
+	{
+		return tables.GetPhase1Distance(twist, flip, slice);
+	}
+
+	int GetPhase2Distance(int corner, int edge, int slicePermutation) const
+	{
+		return std::max(tables.cornerSlicePruning[corner * slicePermutationCount + slicePermutation], tables.edgeSlicePruning[edge * slicePermutationCount + slicePermutation]);
+	}
+
+	// Moves on the same face are merged, and moves on opposite faces are only tried in one order
+	static bool IsRedundant(int move, int previousMove)
+	{
+		int face = move / 3;
+		int previousFace = previousMove / 3;
+
+		return face == previousFace || face + 3 == previousFace;
+	}
+
+	// Returns true once the search can stop
+	bool SearchPhase1(int twist, int flip, int slice, int depth, int remaining)
+	{
+		++nodeCount;
+
+		if (nodeCount >= nodeLimit)
+		{
+			return true;
+		}
+
+		if (remaining == 0)
+		{
+			// Phase 2 only works on cubes inside the subgroup
+			if (twist != 0 || flip != 0 || slice != 0)
+			{
+				return false;
+			}
+
+			// A phase 1 solution that ends with a phase 2 move is only a longer version of a shorter one, which was tried already
+			if (depth > 0 && IsPhase2Move(path[depth - 1]))
+			{
+				return false;
+			}
+
+			StartPhase2(depth);
+
+			return IsDone();
+		}
+
+		for (int move = 0; move < 18; ++move)
+		{
+			if (depth > 0 && IsRedundant(move, path[depth - 1]))
+			{
+				continue;
+			}
+
+			int nextTwist = tables.twistMoves[twist * 18 + move];
+			int nextFlip = tables.flipMoves[flip * 18 + move];
+			int nextSlice = tables.sliceMoves[slice * 18 + move];
+
+			if (GetPhase1Distance(nextTwist, nextFlip, nextSlice) >= remaining)
+			{
+				continue;
+			}
+
+			path[depth] = move;
+
+			if (SearchPhase1(nextTwist, nextFlip, nextSlice, depth + 1, remaining - 1))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// The phase 2 coordinates are not tracked during phase 1, so they are read from the cube after the phase 1 moves
+	void StartPhase2(int phase1Length)
+	{
+		CubeState state = startState;
+		state.ApplyMoves(path.data(), phase1Length);
+
+		int corner = GetCornerPermutation(state);
+		int edge = GetEdgePermutation(state);
+		int slicePermutation = GetSlicePermutation(state);
+
+		for (int phase2Length = GetPhase2Distance(corner, edge, slicePermutation); phase1Length + phase2Length <= maxLength && nodeCount < nodeLimit; ++phase2Length)
+		{
+			if (SearchPhase2(corner, edge, slicePermutation, phase1Length, phase2Length))
+			{
+				solutionLength = phase1Length + phase2Length;
+				solution = path;
+				solutionDirection = searchDirection;
+				maxLength = solutionLength - 1;
+
+				return;
+			}
+		}
+	}
+
+	// Gives up once the node limit is reached, StartPhase2 then stops without a solution
+	bool SearchPhase2(int corner, int edge, int slicePermutation, int depth, int remaining)
+	{
+		++nodeCount;
+
+		if (remaining == 0)
+		{
+			return true;
+		}
+
+		if (nodeCount >= nodeLimit)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < 10; ++i)
+		{
+			int move = phase2Moves[i];
+
+			if (depth > 0 && IsRedundant(move, path[depth - 1]))
+			{
+				continue;
+			}
+
+			int nextCorner = tables.cornerPermutationMoves[corner * 18 + move];
+			int nextEdge = tables.edgePermutationMoves[edge * 18 + move];
+			int nextSlicePermutation = tables.slicePermutationMoves[slicePermutation * 18 + move];
+
+			if (GetPhase2Distance(nextCorner, nextEdge, nextSlicePermutation) >= remaining)
+			{
+				continue;
+			}
+
+			path[depth] = move;
+
+			if (SearchPhase2(nextCorner, nextEdge, nextSlicePermutation, depth + 1, remaining - 1))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Every allocation of this program goes through these, so the allocation benchmark can check that a code path never allocates
+// They are only linked into this target, the application itself keeps the standard operators
+static std::atomic<int64_t> allocationCount(0);
+
+int64_t GetAllocationCount()
+{
+	return allocationCount;
+}
+
+static void* Allocate(std::size_t size) noexcept
+{
+	++allocationCount;
+
+	return malloc(size > 0 ? size : 1);
+}
+
+void* operator new(std::size_t size)
+{
+	void* memory = Allocate(size);
+
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+#ifdef __cpp_aligned_new
+// Over-aligned types use these, the memory has to be freed by the matching aligned function
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+	++allocationCount;
+
+	std::size_t alignmentSize = static_cast<std::size_t>(alignment);
+	size = size > 0 ? size : 1;
+
+#ifdef _WIN32
+	return _aligned_malloc(size, alignmentSize);
+#else
+	return aligned_alloc(alignmentSize, (size + alignmentSize - 1) / alignmentSize * alignmentSize);
+#endif
+}
+
+static void FreeAligned(void* memory) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* memory = AllocateAligned(size, alignment);
+
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(memory);
+}
+#endif
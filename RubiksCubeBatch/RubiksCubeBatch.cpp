@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "BatchSolver.h"
+
+// Headless batch solver, it shares the solver headers with RubiksCube but links none of the window, sound or OpenGL libraries
+// Usage: RubiksCubeBatch [file] [--threads n] [--target n] [--nodes n] [--window n]
+// Reads scrambles or states of 54 facelets from the file or from stdin, writes the solutions to stdout and the report to stderr
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: RubiksCubeBatch [file] [--threads n] [--target n] [--nodes n] [--window n]" << std::endl;
+	std::cerr << "Reads one scramble per line, like \"R U R' U' F2\", and writes one solution per line in the same order" << std::endl;
+	std::cerr << "A line can hold the 54 facelets of a cube instead, in the order U R F D L B, like UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	BatchSolverSettings settings;
+	std::string inputPath;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--help")
+		{
+			PrintUsage();
+			return 0;
+		}
+		else if (argument == "--threads" && i + 1 < argc)
+		{
+			settings.threadCount = std::max(1, atoi(argv[++i]));
+		}
+		else if (argument == "--target" && i + 1 < argc)
+		{
+			settings.targetLength = std::max(0, atoi(argv[++i]));
+		}
+		else if (argument == "--nodes" && i + 1 < argc)
+		{
+			settings.nodeLimit = std::max(1ll, atoll(argv[++i]));
+		}
+		else if (argument == "--window" && i + 1 < argc)
+		{
+			settings.windowSize = std::max(1, atoi(argv[++i]));
+		}
+		else if (inputPath.empty() && argument.compare(0, 2, "--") != 0)
+		{
+			inputPath = argument;
+		}
+		else
+		{
+			PrintUsage();
+			return -1;
+		}
+	}
+
+	// Solutions are written in large blocks, the writer flushes once at the end
+	std::ios::sync_with_stdio(false);
+
+	std::cerr << "Searching with " << settings.threadCount << " threads" << std::endl;
+
+	BatchSolverReport report;
+
+	if (inputPath.empty())
+	{
+		report = RunBatchSolver(std::cin, std::cout, settings);
+	}
+	else
+	{
+		std::ifstream input(inputPath);
+
+		if (!input)
+		{
+			std::cerr << "Could not open " << inputPath << std::endl;
+			return -1;
+		}
+
+		report = RunBatchSolver(input, std::cout, settings);
+	}
+
+	PrintBatchSolverReport(report, std::cerr);
+
+	return 0;
+}